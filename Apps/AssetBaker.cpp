@@ -0,0 +1,157 @@
+// AssetBaker.cpp - bake the game's images, font and sounds into one AssetPack
+// build with ImageLoader.cpp, Atlas.cpp and Lib/GLState.cpp (which link OpenGL for the upload code, unused here), AudioMixer.cpp, AudioSink.cpp, WavFile.cpp and MappedFile.cpp
+// (on Windows, so the game's MP3 sounds can be decoded)
+// run from the game directory after FontBaker; usage: AssetBaker [pack, default game.pack] [extra sound ...]
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "AssetPack.h"
+#include "Assets.h"
+#include "Atlas.h"
+#include "AudioMixer.h"
+#include "BrickRenderer.h"
+#include "ImageLoader.h"
+
+// on screen, sprites are at most 40 pixels across and bricks 58x20, so the
+// pack keeps them little larger than that; mipmaps handle the shrinking
+const int SPRITE_MAX_SIDE = 64, BRICK_LAYER_WIDTH = 64, BRICK_LAYER_HEIGHT = 32;
+
+struct Entry {
+    PackEntry header;
+    std::vector<unsigned char> data;
+};
+
+std::vector<Entry> entries;
+
+void Add(const char *name, int type, const void *data, int size, int p0 = 0, int p1 = 0, int p2 = 0, int p3 = 0) {
+    Entry e;
+    memset(&e.header, 0, sizeof(e.header));
+    strncpy(e.header.name, name, sizeof(e.header.name) - 1);
+    e.header.type = type;
+    e.header.size = size;
+    int params[] = { p0, p1, p2, p3 };
+    memcpy(e.header.params, params, sizeof(params));
+    e.data.assign((const unsigned char *) data, (const unsigned char *) data + size);
+    entries.push_back(e);
+}
+
+bool BakeSprites(const Image images[]) {
+    TextureAtlas atlas;
+    std::vector<unsigned char> page;
+    if (!atlas.compose(images, NSPRITES, page, SPRITE_MAX_SIDE))
+        return false;
+    std::vector<AtlasRect> rects;
+    for (int i = 0; i < NSPRITES; i++)
+        rects.push_back(atlas.rect(i));
+    Add(PACK_SPRITES, PACK_TEXTURE, page.data(), (int) page.size(), atlas.width, atlas.height, 1, 1);
+    Add(PACK_SPRITE_RECTS, PACK_BLOB, rects.data(), (int) (rects.size() * sizeof(AtlasRect)));
+    return true;
+}
+
+bool BakeBricks(const Image images[]) {
+    // level by level, each level every layer, down to 1x1
+    int nLevels = 1;
+    while ((BRICK_LAYER_WIDTH >> nLevels) || (BRICK_LAYER_HEIGHT >> nLevels))
+        nLevels++;
+    std::vector<std::vector<unsigned char>> layers(BrickRenderer::NLAYERS);
+    std::vector<unsigned char> chain;
+    for (int level = 0; level < nLevels; level++) {
+        int w = std::max(1, BRICK_LAYER_WIDTH >> level), h = std::max(1, BRICK_LAYER_HEIGHT >> level);
+        for (int i = 0; i < BrickRenderer::NLAYERS; i++) {
+            std::vector<unsigned char> next(w * h * 4);
+            if (level == 0) {
+                const Image &im = images[brickLayerSprites[i]];
+                if (im.pixels.empty())
+                    return false;
+                ResampleRGBA(im.pixels.data(), im.width, im.height, next.data(), w, h);
+            }
+            else
+                ResampleRGBA(layers[i].data(), std::max(1, BRICK_LAYER_WIDTH >> (level - 1)), std::max(1, BRICK_LAYER_HEIGHT >> (level - 1)), next.data(), w, h);
+            chain.insert(chain.end(), next.begin(), next.end());
+            layers[i].swap(next);
+        }
+    }
+    Add(PACK_BRICKS, PACK_TEXTURE, chain.data(), (int) chain.size(), BRICK_LAYER_WIDTH, BRICK_LAYER_HEIGHT, BrickRenderer::NLAYERS, nLevels);
+    return true;
+}
+
+bool ReadFile(const char *filename, std::vector<unsigned char> &bytes) {
+    FILE *in = fopen(filename, "rb");
+    if (!in)
+        return false;
+    fseek(in, 0, SEEK_END);
+    bytes.resize(ftell(in));
+    fseek(in, 0, SEEK_SET);
+    bool ok = fread(bytes.data(), 1, bytes.size(), in) == bytes.size();
+    fclose(in);
+    return ok;
+}
+
+bool BakeSound(const char *filename) {
+    // in the mixer's format, so the game mixes straight from the mapped pack
+    Pcm pcm;
+    if (!DecodeSound(filename, pcm))
+        return false;
+    std::vector<short> stereo;
+    ConvertPcm(pcm.samples.data(), pcm.frames(), pcm.channels, pcm.rate, AudioMixer::RATE, stereo);
+    Add(filename, PACK_PCM, stereo.data(), (int) (stereo.size() * sizeof(short)), AudioMixer::RATE, 2, (int) stereo.size() / 2);
+    return true;
+}
+
+bool Write(const char *filename) {
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return strcmp(a.header.name, b.header.name) < 0; });
+    int offset = (int) (sizeof(PackHeader) + entries.size() * sizeof(PackEntry));
+    for (Entry &e : entries) {
+        offset = (offset + 15) & ~15;
+        e.header.offset = offset;
+        offset += e.header.size;
+    }
+    FILE *out = fopen(filename, "wb");
+    if (!out)
+        return false;
+    PackHeader header = { { 'B', 'B', 'P', '1' }, ASSET_PACK_VERSION, (int) entries.size(), 0 };
+    fwrite(&header, sizeof(header), 1, out);
+    for (const Entry &e : entries)
+        fwrite(&e.header, sizeof(PackEntry), 1, out);
+    for (const Entry &e : entries) {
+        static const char zeros[16] = { 0 };
+        fwrite(zeros, 1, e.header.offset - ftell(out), out);
+        fwrite(e.data.data(), 1, e.data.size(), out);
+    }
+    bool ok = !ferror(out);
+    fclose(out);
+    return ok;
+}
+
+int main(int ac, char **av) {
+    const char *packFile = ac > 1 ? av[1] : assetPackFile;
+    ImageLoader loader;
+    loader.start(spriteFiles, NSPRITES);
+    loader.wait();
+    if (!BakeSprites(loader.data()) || !BakeBricks(loader.data())) {
+        fprintf(stderr, "can't bake sprites\n");
+        return 1;
+    }
+    std::vector<unsigned char> font;
+    if (!ReadFile("Font/Arial.sdf", font)) {
+        fprintf(stderr, "can't read Font/Arial.sdf (run FontBaker first)\n");
+        return 1;
+    }
+    Add(PACK_FONT, PACK_BLOB, font.data(), (int) font.size());
+    for (int i = 0; i < NSOUNDS; i++) // a missing sound is left out, and is silent in the game
+        BakeSound(soundFiles[i]);
+    for (int i = 2; i < ac; i++)
+        BakeSound(av[i]);
+    if (!Write(packFile)) {
+        fprintf(stderr, "can't write %s\n", packFile);
+        return 1;
+    }
+    for (const Entry &e : entries)
+        printf("%-24s %8d bytes\n", e.header.name, e.header.size);
+    return 0;
+}
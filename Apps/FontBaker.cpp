@@ -0,0 +1,176 @@
+// FontBaker.cpp - bake a TrueType font into a signed-distance-field atlas for SdfFont
+// build with FreeType (the only program that needs it)
+// usage: FontBaker font.ttf atlas.sdf [em size, default 32] [spread, default 4]
+
+#include <ft2build.h>
+#include <freetype/freetype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "SdfFont.h"
+
+const int FIRST_CHAR = 32, LAST_CHAR = 126; // printable ASCII
+const int UPSCALE = 8; // outlines are rasterized at this multiple of the em size, then sampled down
+const int ATLAS_WIDTH = 256;
+const double FAR = 1e20;
+
+// Exact squared Euclidean distance transform (Felzenszwalb and Huttenlocher):
+// on entry a cell is 0 on a feature and FAR elsewhere; on return it holds its
+// squared distance to the nearest feature. Separable, so one pass per axis.
+
+double Intersect(const double *f, int p, int q) {
+    // where the parabolas rooted at p and q > p cross
+    return ((f[q] + (double) q * q) - (f[p] + (double) p * p)) / (2.0 * (q - p));
+}
+
+void Transform1D(const double *f, double *d, int n, std::vector<int> &v, std::vector<double> &z) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -FAR;
+    z[1] = FAR;
+    for (int q = 1; q < n; q++) {
+        double s = Intersect(f, v[k], q);
+        while (s <= z[k]) // z[0] is -FAR, so this stops at k == 0
+            s = Intersect(f, v[--k], q);
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = FAR;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q)
+            k++;
+        d[q] = (double) (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+void Transform(std::vector<double> &grid, int w, int h) {
+    int n = std::max(w, h);
+    std::vector<double> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+    for (int x = 0; x < w; x++) {
+        for (int y = 0; y < h; y++)
+            f[y] = grid[y * w + x];
+        Transform1D(f.data(), d.data(), h, v, z);
+        for (int y = 0; y < h; y++)
+            grid[y * w + x] = d[y];
+    }
+    for (int y = 0; y < h; y++) {
+        Transform1D(&grid[y * w], d.data(), w, v, z);
+        std::copy(d.begin(), d.begin() + w, grid.begin() + y * w);
+    }
+}
+
+struct Baked {
+    SdfGlyph glyph;
+    std::vector<unsigned char> pixels;
+};
+
+void BakeGlyph(FT_GlyphSlot g, int spread, Baked &out) {
+    // pad the high-resolution coverage by the spread, then sample the signed distance at each atlas texel center
+    int margin = spread * UPSCALE, bw = (int) g->bitmap.width, bh = (int) g->bitmap.rows;
+    int w = (bw + 2 * margin + UPSCALE - 1) / UPSCALE, h = (bh + 2 * margin + UPSCALE - 1) / UPSCALE;
+    int pw = w * UPSCALE, ph = h * UPSCALE;
+    std::vector<double> toInside(pw * ph, FAR), toOutside(pw * ph, 0);
+    for (int y = 0; y < bh; y++)
+        for (int x = 0; x < bw; x++)
+            if (g->bitmap.buffer[y * g->bitmap.pitch + x] >= 128) {
+                int i = (y + margin) * pw + x + margin;
+                toInside[i] = 0;
+                toOutside[i] = FAR;
+            }
+    Transform(toInside, pw, ph);
+    Transform(toOutside, pw, ph);
+    out.glyph.w = w;
+    out.glyph.h = h;
+    out.glyph.left = (float) (g->bitmap_left - margin) / UPSCALE;
+    out.glyph.top = (float) (g->bitmap_top + margin) / UPSCALE;
+    out.pixels.resize(w * h);
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++) {
+            int i = (y * UPSCALE + UPSCALE / 2) * pw + x * UPSCALE + UPSCALE / 2;
+            double d = toInside[i] > 0 ? .5 - sqrt(toInside[i]) : sqrt(toOutside[i]) - .5; // high-res pixels, + inside
+            double v = 128 + d / UPSCALE * 127 / spread;
+            out.pixels[y * w + x] = (unsigned char) std::min(255.0, std::max(0.0, floor(v + .5)));
+        }
+}
+
+int main(int ac, char **av) {
+    if (ac < 3) {
+        fprintf(stderr, "usage: FontBaker font.ttf atlas.sdf [em size] [spread]\n");
+        return 1;
+    }
+    int emSize = ac > 3 ? atoi(av[3]) : 32, spread = ac > 4 ? atoi(av[4]) : 4;
+    FT_Library ft;
+    FT_Face face;
+    if (FT_Init_FreeType(&ft) || FT_New_Face(ft, av[1], 0, &face)) {
+        fprintf(stderr, "can't load %s\n", av[1]);
+        return 1;
+    }
+    FT_Set_Pixel_Sizes(face, 0, emSize * UPSCALE);
+    std::vector<Baked> baked(LAST_CHAR - FIRST_CHAR + 1);
+    for (int c = FIRST_CHAR; c <= LAST_CHAR; c++) {
+        Baked &b = baked[c - FIRST_CHAR];
+        memset(&b.glyph, 0, sizeof(b.glyph));
+        if (FT_Load_Char(face, c, FT_LOAD_RENDER | FT_LOAD_NO_HINTING)) // unhinted, so metrics scale exactly
+            continue;
+        b.glyph.advance = face->glyph->advance.x / 64.f / UPSCALE;
+        if (face->glyph->bitmap.width && face->glyph->bitmap.rows)
+            BakeGlyph(face->glyph, spread, b);
+    }
+    SdfFontHeader header;
+    memcpy(header.magic, "BSDF", 4);
+    header.version = SDF_FONT_VERSION;
+    header.emSize = emSize;
+    header.spread = spread;
+    header.ascender = face->size->metrics.ascender / 64.f / UPSCALE;
+    header.descender = face->size->metrics.descender / 64.f / UPSCALE;
+    header.lineHeight = face->size->metrics.height / 64.f / UPSCALE;
+    header.firstChar = FIRST_CHAR;
+    header.nGlyphs = (int) baked.size();
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+    // shelves, tallest first, with a 1 texel gap so filtering stays inside a glyph
+    std::vector<int> order;
+    for (int i = 0; i < (int) baked.size(); i++)
+        if (baked[i].glyph.w)
+            order.push_back(i);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return baked[a].glyph.h > baked[b].glyph.h; });
+    int x = 0, y = 0, shelf = 0;
+    for (int i : order) {
+        SdfGlyph &g = baked[i].glyph;
+        if (x + g.w > ATLAS_WIDTH) {
+            x = 0;
+            y += shelf + 1;
+            shelf = 0;
+        }
+        g.x = x;
+        g.y = y;
+        x += g.w + 1;
+        shelf = std::max(shelf, g.h);
+    }
+    header.width = ATLAS_WIDTH;
+    header.height = (y + shelf + 3) & ~3;
+    std::vector<unsigned char> atlas(header.width * header.height, 0);
+    for (int i : order) {
+        const SdfGlyph &g = baked[i].glyph;
+        for (int row = 0; row < g.h; row++)
+            memcpy(&atlas[(g.y + row) * header.width + g.x], &baked[i].pixels[row * g.w], g.w);
+    }
+    FILE *out = fopen(av[2], "wb");
+    if (!out) {
+        fprintf(stderr, "can't write %s\n", av[2]);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, out);
+    for (const Baked &b : baked)
+        fwrite(&b.glyph, sizeof(SdfGlyph), 1, out);
+    fwrite(atlas.data(), 1, atlas.size(), out);
+    fclose(out);
+    printf("%s: %d glyphs, %d x %d atlas at %d px/em, spread %d\n", av[2], header.nGlyphs, header.width, header.height, emSize, spread);
+    return 0;
+}
@@ -0,0 +1,27 @@
+// ReplayRunner.cpp - re-run a recorded session headlessly and report the outcome
+// build with GameWorld.cpp, BrickGrid.cpp, Sweep.cpp, BrickBits.cpp, Timers.cpp, Replay.cpp
+
+#include <stdio.h>
+#include <chrono>
+#include "Replay.h"
+
+int main(int argc, char **argv) {
+    const char *filename = argc > 1 ? argv[1] : "session.bbr";
+    std::vector<unsigned char> bytes;
+    if (!ReadReplay(filename, bytes)) {
+        printf("can't read %s\n", filename);
+        return 1;
+    }
+    GameWorld world;
+    long long ticks = 0;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = PlayReplay(bytes, world, &ticks);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    if (!ok)
+        printf("%s: malformed or truncated log, stopped after %lld ticks\n", filename, ticks);
+    printf("%s: %u bytes, %lld ticks (%.1f s game time)\n", filename, (unsigned) bytes.size(), ticks, ticks*SIM_DT);
+    printf("level %d, state %d, score %d, lives %d, bricks broken %d\n",
+           world.level, (int) world.state, world.score, world.lives, world.bricksBroken);
+    printf("replayed in %.3f s (%.0f ticks/s)\n", secs, secs > 0 ? ticks/secs : 0.);
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,160 @@
+// SimBench.cpp - headless simulation throughput benchmark, results as JSON on stdout
+// build with GameWorld.cpp, BrickGrid.cpp, Sweep.cpp, BrickBits.cpp, Timers.cpp
+// usage: SimBench [ticks per scenario]
+// tickNanos percentiles are over batches of batchTicks ticks, each batch's mean tick
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "GameWorld.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// A tick costs about as much as a pair of clock reads, so ticks are never timed
+// one by one: throughput comes from an untimed pass and tick times from
+// batches. Phase times have the cost of a clock read taken off each lap, as
+// measured in place: the phase pass's extra time over the untimed pass, spread
+// over its reads.
+const int BATCH = 64; // ticks per timed batch
+
+enum Pass { UNTIMED, BATCHES, PHASES };
+
+struct Scenario {
+    const char *name;
+    int level, rows, cols;
+};
+
+// the three shipped levels, then synthetic fields: full screen, and wider than
+// the screen to load the broadphase and bitboard (off-screen bricks are never hit)
+Scenario scenarios[] = {
+    { "level1", 1, BRICK_ROWS, BRICK_COLS },
+    { "level2", 2, BRICK_ROWS, BRICK_COLS },
+    { "level3", 3, BRICK_ROWS, BRICK_COLS },
+    { "grid20x13", 3, 20, 13 },
+    { "grid20x64", 3, 20, 64 },
+    { "grid22x256", 3, 22, 256 }
+};
+
+// Scripted player: nudge the aim, launch, then track the ball and fire when armed
+GameInput Bot(const GameWorld &world, Rng &rng) {
+    GameInput input;
+    if (world.state == AIM || world.ball.idle) {
+        input.aim = rng.below(3) - 1;
+        input.space = rng.below(50) == 0;
+        return input;
+    }
+    float center = world.paddle.x + world.paddle.width / 2, slack = world.paddle.width / 4;
+    bool left = world.ball.x < center - slack, right = world.ball.x > center + slack;
+    if (world.paddle.controlsFlipped)
+        std::swap(left, right);
+    input.moveLeft = left;
+    input.moveRight = right;
+    input.space = world.ball.hasGun && rng.below(100) == 0;
+    return input;
+}
+
+struct Run {
+    long long ticks = 0, games = 0, cleared = 0;
+    double seconds = 0;
+    std::vector<double> tickNanos; // BATCHES: mean tick time of each batch, clock read removed
+    double nanos = 0; // BATCHES: total of all batches
+    PhaseTimes phases; // PHASES
+};
+
+volatile long long clockSink; // so ClockNanos's reads can't be dropped
+
+double ClockNanos() {
+    // cost of one Clock::now, the least of several runs so a preemption doesn't count
+    const int n = 200000;
+    double best = 1e9;
+    for (int run = 0; run < 5; run++) {
+        long long sum = 0;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < n; i++)
+            sum += Clock::now().time_since_epoch().count();
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count() / n);
+        clockSink = sum;
+    }
+    return best;
+}
+
+// Play scenario s for a fixed tick count, restarting on game over or level complete.
+// The same seed gives the same game, so every pass replays the same ticks.
+Run Play(const Scenario &s, long long ticks, Pass pass, double clockNanos) {
+    Run run;
+    GameWorld world;
+    Rng rng;
+    rng.state = 2024;
+    world.seed(1);
+    world.reset(s.level, s.rows, s.cols);
+    if (pass == PHASES)
+        world.phaseTimes = &run.phases;
+    if (pass == BATCHES)
+        run.tickNanos.reserve((size_t) (ticks / BATCH + 1));
+    Clock::time_point start = Clock::now(), batchStart = start;
+    for (; run.ticks < ticks; run.ticks++) {
+        if (world.state != AIM && world.state != GAME) {
+            run.games++;
+            run.cleared += world.state == LEVEL_COMPLETE;
+            world.reset(s.level, s.rows, s.cols);
+        }
+        world.step(Bot(world, rng));
+        int done = (int) ((run.ticks + 1) % BATCH);
+        if (pass == BATCHES && (done == 0 || run.ticks + 1 == ticks)) {
+            // each batch spans one clock read, since one batch's end is the next one's start
+            int n = done ? done : BATCH;
+            Clock::time_point now = Clock::now();
+            double ns = std::chrono::duration<double, std::nano>(now - batchStart).count() - clockNanos;
+            run.tickNanos.push_back(std::max(0., ns / n));
+            run.nanos += n * run.tickNanos.back();
+            batchStart = now;
+        }
+    }
+    run.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return run;
+}
+
+double Percentile(std::vector<double> &sorted, double p) {
+    if (sorted.empty())
+        return 0;
+    size_t i = (size_t) (p * (sorted.size() - 1) + .5);
+    return sorted[i];
+}
+
+int main(int argc, char **argv) {
+    long long ticks = argc > 1 ? atoll(argv[1]) : 1000000;
+    if (ticks <= 0) {
+        fprintf(stderr, "usage: SimBench [ticks per scenario, > 0]\n");
+        return 1;
+    }
+    const char *phaseNames[] = { "input", "paddle", "ball", "powerUps", "bullets" };
+    int nScenarios = sizeof(scenarios) / sizeof(scenarios[0]);
+    double clockNanos = ClockNanos();
+    printf("{\n  \"ticksPerScenario\": %lld,\n  \"simHz\": %d,\n  \"batchTicks\": %d,\n  \"clockNanos\": %.1f,\n  \"scenarios\": [\n",
+           ticks, SIM_HZ, BATCH, clockNanos);
+    for (int i = 0; i < nScenarios; i++) {
+        const Scenario &s = scenarios[i];
+        Run plain = Play(s, ticks, UNTIMED, clockNanos), batched = Play(s, ticks, BATCHES, clockNanos), timed = Play(s, ticks, PHASES, clockNanos);
+        std::vector<double> &ns = batched.tickNanos;
+        std::sort(ns.begin(), ns.end());
+        double mean = batched.nanos / batched.ticks;
+        printf("    {\n      \"name\": \"%s\", \"level\": %d, \"rows\": %d, \"cols\": %d,\n", s.name, s.level, s.rows, s.cols);
+        printf("      \"ticks\": %lld, \"games\": %lld, \"levelsCleared\": %lld,\n", plain.ticks, plain.games, plain.cleared);
+        printf("      \"seconds\": %.6f, \"ticksPerSecond\": %.0f,\n", plain.seconds, plain.ticks / plain.seconds);
+        printf("      \"tickNanos\": { \"mean\": %.1f, \"p50\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f },\n",
+               mean, Percentile(ns, .5), Percentile(ns, .99), Percentile(ns, .999), Percentile(ns, 1));
+        long long reads = timed.ticks; // one as each step starts, then one per lap
+        for (long long laps : timed.phases.laps)
+            reads += laps;
+        double lapNanos = std::max(0., (timed.seconds - plain.seconds) * 1e9 / reads);
+        printf("      \"phaseNanosPerTick\": {");
+        for (int p = 0; p < PhaseTimes::NPHASES; p++)
+            printf(" \"%s\": %.1f%s", phaseNames[p], std::max(0., timed.phases.nanos[p] - lapNanos * timed.phases.laps[p]) / timed.ticks,
+                   p < PhaseTimes::NPHASES - 1 ? "," : " }\n");
+        printf("    }%s\n", i < nScenarios - 1 ? "," : "");
+    }
+    printf("  ]\n}\n");
+    return 0;
+}
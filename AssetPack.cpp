@@ -0,0 +1,57 @@
+// AssetPack.cpp - indexed file of pre-baked assets, memory-mapped and used in place
+
+#include "AssetPack.h"
+#include <stdio.h>
+#include <string.h>
+
+bool AssetPack::open(const char *filename) {
+    entries = nullptr;
+    nEntries = 0;
+    if (!file.open(filename))
+        return false;
+    const PackHeader *h = (const PackHeader *) file.data();
+    long long indexEnd = (long long) sizeof(PackHeader) + (file.size() >= (int) sizeof(PackHeader) ? (long long) h->nEntries * sizeof(PackEntry) : 0);
+    bool ok = file.size() >= (int) sizeof(PackHeader) && !memcmp(h->magic, "BBP1", 4) && h->version == ASSET_PACK_VERSION &&
+        h->nEntries >= 0 && indexEnd <= file.size();
+    const PackEntry *e = (const PackEntry *) (file.data() + sizeof(PackHeader));
+    for (int i = 0; ok && i < h->nEntries; i++)
+        ok = e[i].offset >= indexEnd && e[i].size >= 0 && (long long) e[i].offset + e[i].size <= file.size() && memchr(e[i].name, 0, sizeof(e[i].name));
+    if (!ok) {
+        fprintf(stderr, "AssetPack: %s is not a version %d pack; rebake it with AssetBaker\n", filename, ASSET_PACK_VERSION);
+        file.close();
+        return false;
+    }
+    entries = e;
+    nEntries = h->nEntries;
+    return true;
+}
+
+const PackEntry *AssetPack::find(const char *name, int type) const {
+    int lo = 0, hi = nEntries - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2, c = strcmp(entries[mid].name, name);
+        if (c == 0)
+            return entries[mid].type == type ? &entries[mid] : nullptr;
+        if (c < 0)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return nullptr;
+}
+
+int AssetPack::textureLevelBytes(const PackEntry &e, int level) const {
+    int w = e.params[0] >> level, h = e.params[1] >> level;
+    return (w > 0 ? w : 1) * (h > 0 ? h : 1) * e.params[2] * 4;
+}
+
+bool AssetPack::textureFits(const PackEntry &e) const {
+    // no level is larger than level 0, so once that fits in size textureLevelBytes can't overflow
+    const int *p = e.params;
+    if (e.type != PACK_TEXTURE || p[0] < 1 || p[1] < 1 || p[2] < 1 || p[3] < 1 || p[3] > 31 || p[0] > e.size / 4 / p[1] / p[2])
+        return false;
+    long long bytes = 0;
+    for (int level = 0; level < p[3] && bytes <= e.size; level++)
+        bytes += textureLevelBytes(e, level);
+    return bytes == e.size;
+}
@@ -0,0 +1,55 @@
+// AssetPack.h - indexed file of pre-baked assets, memory-mapped and used in place
+
+#ifndef ASSETPACK_HDR
+#define ASSETPACK_HDR
+
+#include "MappedFile.h"
+
+// Apps/AssetBaker decodes, resizes and mipmaps the game's images, and decodes
+// its sounds, once at build time; the game maps the result and hands each
+// entry's bytes straight to glTexImage or the mixer. Nothing is parsed at run
+// time beyond a binary search of the index, and only the pages an upload
+// touches are ever read.
+//
+// Layout (little-endian): PackHeader, nEntries PackEntry sorted by name, then
+// each entry's data at a 16-byte aligned offset from the start of the file.
+
+enum PackType { PACK_TEXTURE = 1, PACK_PCM, PACK_BLOB };
+
+struct PackHeader {
+    char magic[4]; // "BBP1"
+    int version;
+    int nEntries;
+    int reserved;
+};
+
+struct PackEntry {
+    char name[32]; // null-terminated
+    int type; // PackType
+    int offset, size; // data, in bytes
+    int params[4];
+        // PACK_TEXTURE: width, height, layers, levels; RGBA8, level by level, each level all layers, top row first
+        // PACK_PCM: sample rate, channels, frames; 16-bit interleaved
+        // PACK_BLOB: unused
+};
+
+const int ASSET_PACK_VERSION = 1;
+
+class AssetPack {
+public:
+    bool open(const char *filename);
+        // map a pack; return false if missing, truncated or of another version
+    const PackEntry *find(const char *name, int type) const;
+        // null if there's no entry by that name and type
+    const unsigned char *data(const PackEntry &e) const { return file.data() + e.offset; }
+    int textureLevelBytes(const PackEntry &e, int level) const;
+        // bytes in one mip level of a PACK_TEXTURE, all layers
+    bool textureFits(const PackEntry &e) const;
+        // true if a PACK_TEXTURE's params are sane and its levels sum to exactly its size, so uploads stay in the entry
+private:
+    MappedFile file;
+    const PackEntry *entries = nullptr;
+    int nEntries = 0;
+};
+
+#endif
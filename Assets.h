@@ -0,0 +1,27 @@
+// Assets.h - the game's image and sound files, shared by the game and Apps/AssetBaker
+
+#ifndef ASSETS_HDR
+#define ASSETS_HDR
+
+enum Sprite { BOMB_SPRITE, STAGE1_SPRITE, STAGE2_SPRITE, STAGE3_SPRITE, FIREBALL_SPRITE, BULLET_SPRITE, NSPRITES };
+
+const char *const spriteFiles[NSPRITES] = { "Image/bomb.png", "Image/stage1.png", "Image/stage2.png", "Image/stage3.jpg", "Image/fireball.png", "Image/bullet1.png" };
+
+// sprites for BrickRenderer's layers, in BrickRenderer::Layer order
+const Sprite brickLayerSprites[] = { STAGE1_SPRITE, STAGE2_SPRITE, STAGE3_SPRITE, BOMB_SPRITE };
+
+enum Sound { BREAK_SOUND, BOMB_SOUND, NSOUNDS };
+
+// decoded by DecodeSound (MP3 needs Windows); a baked pack holds them as PCM, so needs neither
+const char *const soundFiles[NSOUNDS] = { "Sound/break.mp3", "Sound/bomb.mp3" };
+
+const char *const assetPackFile = "game.pack";
+
+// entry names in the pack
+const char *const PACK_SPRITES = "sprites"; // atlas page, RGBA8, one level
+const char *const PACK_SPRITE_RECTS = "sprites.rects"; // NSPRITES AtlasRect
+const char *const PACK_BRICKS = "bricks"; // one layer per BrickRenderer::Layer, with mip chain
+const char *const PACK_FONT = "font"; // SdfFont file, verbatim
+// each sound is a PACK_PCM entry named by its soundFiles path
+
+#endif
@@ -0,0 +1,200 @@
+// Atlas.cpp - pack images into one texture with a skyline packer
+
+#include <GLFW/glfw3.h>
+#include "Atlas.h"
+#include "GLState.h"
+#include "ImageLoader.h"
+#include <stdio.h>
+#include <algorithm>
+
+// Skyline
+
+void SkylinePacker::reset(int w, int h) {
+    width = w;
+    height = h;
+    skyline.assign(1, { 0, 0, w });
+}
+
+int SkylinePacker::fit(int i, int w, int h) const {
+    // y at which a w-wide rect rests if its left edge is at segment i, or -1
+    int x = skyline[i].x, y = 0;
+    if (x + w > width)
+        return -1;
+    for (int left = w; left > 0; left -= skyline[i++].w) {
+        y = std::max(y, skyline[i].y);
+        if (y + h > height)
+            return -1;
+    }
+    return y;
+}
+
+bool SkylinePacker::insert(int w, int h, int &x, int &y) {
+    int bestTop = height + 1, bestWidth = width + 1;
+    int best = (int) skyline.size();
+    for (int i = 0; i < (int) skyline.size(); i++) {
+        int top = fit(i, w, h);
+        if (top >= 0 && (top + h < bestTop || (top + h == bestTop && skyline[i].w < bestWidth))) {
+            best = i;
+            bestTop = top + h;
+            bestWidth = skyline[i].w;
+        }
+    }
+    if (best == (int) skyline.size())
+        return false;
+    x = skyline[best].x;
+    y = bestTop - h;
+    // the new segment covers [x, x+w); trim or drop the segments it shadows
+    skyline.insert(skyline.begin() + best, { x, bestTop, w });
+    for (int i = best + 1; i < (int) skyline.size(); ) {
+        Segment &s = skyline[i];
+        int shadow = x + w - s.x;
+        if (shadow <= 0)
+            break;
+        if (shadow < s.w) {
+            s.x += shadow;
+            s.w -= shadow;
+            break;
+        }
+        skyline.erase(skyline.begin() + i);
+    }
+    // merge neighbors at equal height
+    for (int i = 0; i + 1 < (int) skyline.size(); )
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].w += skyline[i + 1].w;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+            i++;
+    return true;
+}
+
+// Resampling
+
+void ResampleRGBA(const unsigned char *src, int w, int h, unsigned char *dst, int dw, int dh) {
+    std::vector<unsigned char> half;
+    while (w >= 2 * dw && h >= 2 * dh) {
+        // 2x2 box filter; bilinear alone would skip most source pixels
+        int hw = w / 2, hh = h / 2;
+        std::vector<unsigned char> next(hw * hh * 4);
+        for (int j = 0; j < hh; j++)
+            for (int i = 0; i < hw; i++)
+                for (int k = 0; k < 4; k++) {
+                    const unsigned char *p = src + 4 * (2 * j * w + 2 * i) + k;
+                    next[4 * (j * hw + i) + k] = (unsigned char) ((p[0] + p[4] + p[4 * w] + p[4 * w + 4] + 2) / 4);
+                }
+        half.swap(next);
+        src = half.data();
+        w = hw;
+        h = hh;
+    }
+    for (int j = 0; j < dh; j++) {
+        float y = (j + .5f) * h / dh - .5f;
+        int y0 = y < 0 ? 0 : (int) y, y1 = y0 + 1 < h ? y0 + 1 : y0;
+        float fy = y < 0 ? 0 : y - y0;
+        for (int i = 0; i < dw; i++) {
+            float x = (i + .5f) * w / dw - .5f;
+            int x0 = x < 0 ? 0 : (int) x, x1 = x0 + 1 < w ? x0 + 1 : x0;
+            float fx = x < 0 ? 0 : x - x0;
+            const unsigned char *a = src + 4 * (y0 * w + x0), *b = src + 4 * (y0 * w + x1);
+            const unsigned char *c = src + 4 * (y1 * w + x0), *d = src + 4 * (y1 * w + x1);
+            unsigned char *o = dst + 4 * (j * dw + i);
+            for (int k = 0; k < 4; k++) {
+                float top = a[k] + fx * (b[k] - a[k]), bot = c[k] + fx * (d[k] - c[k]);
+                o[k] = (unsigned char) (top + fy * (bot - top) + .5f);
+            }
+        }
+    }
+}
+
+// Atlas
+
+bool TextureAtlas::build(const char *const files[], int nFiles, int maxSide, int padding) {
+    std::vector<Image> decoded(nFiles);
+    for (int i = 0; i < nFiles; i++)
+        DecodeImage(files[i], decoded[i]);
+    return build(decoded.data(), nFiles, maxSide, padding);
+}
+
+bool TextureAtlas::build(const Image images[], int nImages, int maxSide, int padding) {
+    std::vector<unsigned char> page;
+    bool ok = compose(images, nImages, page, maxSide, padding);
+    if (width)
+        upload(page.data());
+    return ok;
+}
+
+bool TextureAtlas::load(const unsigned char *page, int w, int h, const AtlasRect *r, int nRects) {
+    width = w;
+    height = h;
+    rects.assign(r, r + nRects);
+    upload(page);
+    return true;
+}
+
+void TextureAtlas::upload(const unsigned char *page) {
+    if (!texture)
+        glGenTextures(1, &texture);
+    BindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, page);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    BindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool TextureAtlas::compose(const Image decoded[], int nImages, std::vector<unsigned char> &page, int maxSide, int padding) {
+    struct Scaled { int w = 0, h = 0, x = 0, y = 0; std::vector<unsigned char> pixels; };
+    std::vector<Scaled> images(nImages);
+    bool ok = true;
+    for (int i = 0; i < nImages; i++) {
+        const Image &d = decoded[i];
+        if (d.pixels.empty()) {
+            ok = false;
+            continue;
+        }
+        Scaled &im = images[i];
+        float scale = std::min(1.f, (float) maxSide / std::max(d.width, d.height));
+        im.w = std::max(1, (int) (d.width * scale + .5f));
+        im.h = std::max(1, (int) (d.height * scale + .5f));
+        im.pixels.resize(im.w * im.h * 4);
+        ResampleRGBA(d.pixels.data(), d.width, d.height, im.pixels.data(), im.w, im.h);
+    }
+    // tallest first, then grow the page (width, then height) until everything fits
+    std::vector<int> order;
+    for (int i = 0; i < nImages; i++)
+        if (images[i].w)
+            order.push_back(i);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return images[a].h > images[b].h; });
+    SkylinePacker packer;
+    bool packed = false;
+    for (width = height = 64; height <= 4096; (width <= height ? width : height) *= 2) {
+        packer.reset(width, height);
+        packed = true;
+        for (int i : order)
+            if (!packer.insert(images[i].w + 2 * padding, images[i].h + 2 * padding, images[i].x, images[i].y)) {
+                packed = false;
+                break;
+            }
+        if (packed)
+            break;
+    }
+    if (!packed) {
+        fprintf(stderr, "Atlas: images don't fit in 4096 x 4096\n");
+        width = height = 0;
+        return false;
+    }
+    // compose, extruding each image's edge into its padding so filtering doesn't pick up a neighbor
+    page.assign(width * height * 4, 0);
+    rects.assign(nImages, { 0, 0, 0, 0 });
+    for (int i : order) {
+        Scaled &im = images[i];
+        for (int y = -padding; y < im.h + padding; y++)
+            for (int x = -padding; x < im.w + padding; x++) {
+                int sx = std::min(std::max(x, 0), im.w - 1), sy = std::min(std::max(y, 0), im.h - 1);
+                const unsigned char *s = &im.pixels[4 * (sy * im.w + sx)];
+                std::copy(s, s + 4, &page[4 * ((im.y + padding + y) * width + im.x + padding + x)]);
+            }
+        float x0 = (float) (im.x + padding), y0 = (float) (im.y + padding);
+        rects[i] = { x0 / width, y0 / height, (x0 + im.w) / width, (y0 + im.h) / height };
+    }
+    return ok;
+}
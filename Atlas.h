@@ -0,0 +1,55 @@
+// Atlas.h - pack images into one texture with a skyline packer
+
+#ifndef ATLAS_HDR
+#define ATLAS_HDR
+
+#include <vector>
+
+struct Image;
+
+// Bottom-left skyline packing: the free space is kept as the top edge of what
+// has been placed so far, one (x, y, width) segment per step, and each rect goes
+// where its top edge would be lowest. Good enough for a few dozen sprites, and
+// it packs a set sorted by height in O(n * segments).
+
+class SkylinePacker {
+public:
+    void reset(int width, int height);
+    bool insert(int w, int h, int &x, int &y);
+        // place a w x h rect; return false if it doesn't fit
+private:
+    struct Segment { int x, y, w; };
+    std::vector<Segment> skyline;
+    int width = 0, height = 0;
+    int fit(int i, int w, int h) const;
+};
+
+struct AtlasRect {
+    float u0, v0, u1, v1; // texture coordinates of the image's top-left and bottom-right
+    float u(float s) const { return u0 + s * (u1 - u0); }
+    float v(float t) const { return v0 + t * (v1 - v0); }
+};
+
+class TextureAtlas {
+public:
+    bool build(const char *const files[], int nFiles, int maxSide = 256, int padding = 2);
+        // load each file, shrink any side over maxSide (keeping aspect), pack and upload as one GL_TEXTURE_2D
+        // an image that fails to load gets an empty rect; return false if any failed or nothing fits in 4096 x 4096
+    bool build(const Image images[], int nImages, int maxSide = 256, int padding = 2);
+        // as above, from images already decoded (an empty one counts as failed)
+    bool compose(const Image images[], int nImages, std::vector<unsigned char> &page, int maxSide = 256, int padding = 2);
+        // build's packing without GL: fill page (width x height RGBA) and the rects, for an offline bake
+    bool load(const unsigned char *page, int width, int height, const AtlasRect *rects, int nRects);
+        // upload a page composed earlier, as is
+    const AtlasRect &rect(int i) const { return rects[i]; }
+    unsigned int texture = 0;
+    int width = 0, height = 0;
+private:
+    std::vector<AtlasRect> rects;
+    void upload(const unsigned char *page);
+};
+
+void ResampleRGBA(const unsigned char *src, int w, int h, unsigned char *dst, int dw, int dh);
+    // resize an RGBA image: box-halve while more than twice too large, then bilinear
+
+#endif
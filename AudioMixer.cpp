@@ -0,0 +1,328 @@
+// AudioMixer.cpp - sound effects mixed on their own thread, started from the game thread without waiting
+
+#include "AudioMixer.h"
+#include "AudioSink.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+namespace {
+
+bool HasExtension(const char *filename, const char *ext) {
+    size_t n = strlen(filename), e = strlen(ext);
+    if (n < e)
+        return false;
+    for (size_t i = 0; i < e; i++)
+        if (tolower((unsigned char) filename[n - e + i]) != ext[i])
+            return false;
+    return true;
+}
+
+} // end namespace
+
+// Pcm
+
+bool DecodeWav(const char *filename, Pcm &pcm) {
+    pcm = Pcm();
+    WavFile wav;
+    if (!wav.open(filename, WavFile::STREAMED)) {
+        fprintf(stderr, "Failed to load %s (missing, or not an uncompressed 16-bit mono or stereo .wav)\n", filename);
+        return false;
+    }
+    pcm.rate = wav.rate;
+    pcm.channels = wav.channels;
+    pcm.samples.resize(wav.frames * wav.channels);
+    pcm.samples.resize(wav.read(pcm.samples.data(), wav.frames) * wav.channels);
+    return true;
+}
+
+bool DecodeSound(const char *filename, Pcm &pcm) {
+    return HasExtension(filename, ".mp3") ? DecodeMp3(filename, pcm) : DecodeWav(filename, pcm);
+}
+
+void ConvertPcm(const short *samples, int frames, int channels, int rate, int outRate, std::vector<short> &stereo) {
+    int n = (int) ((long long) frames * outRate / rate);
+    stereo.resize(2 * n);
+    for (int i = 0; i < n; i++) {
+        double t = (double) i * rate / outRate;
+        int i0 = std::min((int) t, frames - 1), i1 = std::min(i0 + 1, frames - 1);
+        float a = (float) (t - i0);
+        for (int c = 0; c < 2; c++) {
+            int src = std::min(c, channels - 1);
+            stereo[2 * i + c] = (short) ((1 - a) * samples[i0 * channels + src] + a * samples[i1 * channels + src]);
+        }
+    }
+}
+
+// AudioMixer
+
+int AudioMixer::addSound(const short *samples, int frames, int channels, int rate) {
+    if (running() || !samples || frames <= 0 || channels < 1 || channels > 2 || rate <= 0)
+        return -1;
+    if (channels != 2 || rate != RATE) {
+        converted.emplace_back();
+        ConvertPcm(samples, frames, channels, rate, RATE, converted.back());
+        samples = converted.back().data();
+        frames = (int) converted.back().size() / 2;
+        if (!frames)
+            return -1;
+    }
+    sounds.push_back({ samples, frames, -1 });
+    return (int) sounds.size() - 1;
+}
+
+int AudioMixer::addSound(const char *soundFile) {
+    if (running())
+        return -1;
+    std::unique_ptr<WavFile> wav(new WavFile());
+    if (wav->open(soundFile) && wav->channels == 2 && wav->rate == RATE && wav->frames > 0) {
+        files.push_back(std::move(wav));
+        return addSound(files.back()->samples(), files.back()->frames, 2, RATE);
+    }
+    Pcm pcm;
+    if (!DecodeSound(soundFile, pcm))
+        return -1;
+    if (pcm.channels == 2 && pcm.rate == RATE) {
+        // addSound would use these in place, so they must outlive pcm
+        converted.push_back(std::move(pcm.samples));
+        return addSound(converted.back().data(), (int) converted.back().size() / 2, 2, RATE);
+    }
+    return addSound(pcm.samples.data(), pcm.frames(), pcm.channels, pcm.rate);
+}
+
+int AudioMixer::addStream(const char *wavFile, bool loop) {
+    if (running())
+        return -1;
+    Stream s;
+    s.file.reset(new WavFile());
+    if (!s.file->open(wavFile, WavFile::STREAMED) || s.file->rate != RATE || s.file->frames <= 0) {
+        fprintf(stderr, "Failed to stream %s (missing, or not an uncompressed 16-bit .wav at %d Hz)\n", wavFile, (int) RATE);
+        return -1;
+    }
+    s.buffer.resize(WavFile::STREAM_FRAMES * s.file->channels);
+    s.loop = loop;
+    streams.push_back(std::move(s));
+    sounds.push_back({ nullptr, streams.back().file->frames, (int) streams.size() - 1 });
+    return (int) sounds.size() - 1;
+}
+
+bool AudioMixer::start(AudioSink *s) {
+    stop();
+    if (!s->open(RATE, BLOCK))
+        return false;
+    sink = s;
+    for (Voice &v : voices)
+        v = Voice();
+    quit = false;
+    thread = std::thread(&AudioMixer::run, this);
+    return true;
+}
+
+void AudioMixer::stop() {
+    if (!running())
+        return;
+    quit = true;
+    thread.join();
+    sink->close();
+    sink = nullptr;
+    for (Command c; commands.pop(c); ) // nothing pushes once the thread is gone
+        ;
+}
+
+bool AudioMixer::play(int sound, float gain) {
+    if (sound < 0 || sound >= (int) sounds.size() || !running())
+        return false;
+    if (!commands.push({ sound, gain })) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void AudioMixer::run() {
+    short block[2 * BLOCK];
+    while (!quit.load(std::memory_order_relaxed)) {
+        for (Command c; commands.pop(c); )
+            startVoice(c);
+        mix(block, BLOCK);
+        sink->write(block, BLOCK);
+        mixed.fetch_add(BLOCK, std::memory_order_relaxed);
+    }
+}
+
+AudioMixer::Voice *AudioMixer::findVoice(int sound) {
+    // a playing stream's own voice, else a free voice, else the oldest not streaming; null if all are streaming
+    if (sounds[sound].stream >= 0)
+        for (Voice &w : voices)
+            if (w.sound == sound)
+                return &w;
+    Voice *oldest = nullptr;
+    for (Voice &w : voices) {
+        if (w.sound < 0)
+            return &w;
+        if (sounds[w.sound].stream < 0 && (!oldest || w.position > oldest->position))
+            oldest = &w;
+    }
+    return oldest;
+}
+
+void AudioMixer::startVoice(const Command &c) {
+    Voice *v = findVoice(c.sound);
+    if (!v) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (v->sound >= 0 && sounds[v->sound].stream < 0)
+        stolen.fetch_add(1, std::memory_order_relaxed);
+    int stream = sounds[c.sound].stream;
+    if (stream >= 0) {
+        Stream &s = streams[stream];
+        s.file->rewind();
+        s.buffered = s.next = 0;
+    }
+    *v = { c.sound, 0, c.gain };
+}
+
+bool AudioMixer::refill(Stream &s) {
+    // the only file reads on the mixing thread: one per STREAM_FRAMES, from WavFile's buffer
+    s.next = 0;
+    s.buffered = s.file->read(s.buffer.data(), WavFile::STREAM_FRAMES);
+    if (!s.buffered && s.loop) {
+        s.file->rewind();
+        s.buffered = s.file->read(s.buffer.data(), WavFile::STREAM_FRAMES);
+    }
+    return s.buffered > 0;
+}
+
+void AudioMixer::mixStream(Voice &v, float *sum, int frames) {
+    Stream &s = streams[sounds[v.sound].stream];
+    int channels = s.file->channels;
+    for (int i = 0; i < frames; ) {
+        if (s.next == s.buffered && !refill(s)) {
+            v.sound = -1;
+            return;
+        }
+        int n = std::min(frames - i, s.buffered - s.next);
+        const short *in = s.buffer.data() + s.next * channels;
+        for (int j = 0; j < n; j++, in += channels) {
+            sum[2 * (i + j)] += v.gain * in[0];
+            sum[2 * (i + j) + 1] += v.gain * in[channels - 1];
+        }
+        s.next += n;
+        v.position += n;
+        i += n;
+    }
+}
+
+void AudioMixer::mix(short *out, int frames) {
+    float sum[2 * BLOCK] = { 0 };
+    for (Voice &v : voices) {
+        if (v.sound < 0)
+            continue;
+        const Sound &s = sounds[v.sound];
+        if (s.stream >= 0) {
+            mixStream(v, sum, frames);
+            continue;
+        }
+        int n = std::min(frames, s.frames - v.position);
+        const short *in = s.samples + 2 * v.position;
+        for (int i = 0; i < 2 * n; i++)
+            sum[i] += v.gain * in[i];
+        v.position += n;
+        if (v.position >= s.frames)
+            v.sound = -1;
+    }
+    for (int i = 0; i < 2 * frames; i++)
+        out[i] = (short) std::max(-32768.f, std::min(32767.f, sum[i]));
+}
+
+#ifdef _WIN32
+
+// MP3, by Media Foundation
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <objbase.h>
+#include <mfapi.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+
+#pragma comment(lib, "mfplat.lib")
+#pragma comment(lib, "mfreadwrite.lib")
+#pragma comment(lib, "mfuuid.lib")
+#pragma comment(lib, "ole32.lib")
+
+bool DecodeMp3(const char *filename, Pcm &pcm) {
+    // the source reader decodes to 16-bit PCM at the file's own rate and channels; ConvertPcm does the rest
+    pcm = Pcm();
+    wchar_t path[MAX_PATH];
+    HRESULT com = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED); // fails harmlessly if the thread already has COM
+    bool ok = MultiByteToWideChar(CP_ACP, 0, filename, -1, path, MAX_PATH) > 0 && SUCCEEDED(MFStartup(MF_VERSION, MFSTARTUP_LITE));
+    bool started = ok;
+    IMFSourceReader *reader = NULL;
+    IMFMediaType *type = NULL;
+    UINT32 channels = 0, rate = 0;
+    const DWORD stream = (DWORD) MF_SOURCE_READER_FIRST_AUDIO_STREAM;
+    ok = ok && SUCCEEDED(MFCreateSourceReaderFromURL(path, NULL, &reader)) &&
+        SUCCEEDED(MFCreateMediaType(&type)) &&
+        SUCCEEDED(type->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio)) &&
+        SUCCEEDED(type->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_PCM)) &&
+        SUCCEEDED(type->SetUINT32(MF_MT_AUDIO_BITS_PER_SAMPLE, 16)) &&
+        SUCCEEDED(reader->SetCurrentMediaType(stream, NULL, type));
+    if (type) {
+        type->Release();
+        type = NULL;
+    }
+    ok = ok && SUCCEEDED(reader->GetCurrentMediaType(stream, &type)) &&
+        SUCCEEDED(type->GetUINT32(MF_MT_AUDIO_NUM_CHANNELS, &channels)) &&
+        SUCCEEDED(type->GetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, &rate)) &&
+        channels >= 1 && channels <= 2 && rate > 0;
+    while (ok) {
+        DWORD flags = 0;
+        IMFSample *sample = NULL;
+        IMFMediaBuffer *buffer = NULL;
+        BYTE *bytes = NULL;
+        DWORD size = 0;
+        ok = SUCCEEDED(reader->ReadSample(stream, 0, NULL, &flags, NULL, &sample));
+        if (ok && sample && SUCCEEDED(sample->ConvertToContiguousBuffer(&buffer)) && SUCCEEDED(buffer->Lock(&bytes, NULL, &size))) {
+            pcm.samples.insert(pcm.samples.end(), (const short *) bytes, (const short *) bytes + size / 2);
+            buffer->Unlock();
+        }
+        else if (sample)
+            ok = false;
+        if (buffer)
+            buffer->Release();
+        if (sample)
+            sample->Release();
+        if (flags & MF_SOURCE_READERF_ENDOFSTREAM)
+            break;
+    }
+    if (type)
+        type->Release();
+    if (reader)
+        reader->Release();
+    if (started)
+        MFShutdown();
+    if (SUCCEEDED(com))
+        CoUninitialize();
+    if (!ok || pcm.samples.size() < channels) {
+        fprintf(stderr, "Failed to load %s (missing, or not an MP3 that Media Foundation can decode)\n", filename);
+        pcm = Pcm();
+        return false;
+    }
+    pcm.rate = (int) rate;
+    pcm.channels = (int) channels;
+    pcm.samples.resize(pcm.samples.size() / channels * channels);
+    return true;
+}
+
+#else
+
+bool DecodeMp3(const char *filename, Pcm &pcm) {
+    pcm = Pcm();
+    fprintf(stderr, "Failed to load %s (MP3 is decoded by Media Foundation, so only on Windows; convert it to 16-bit .wav)\n", filename);
+    return false;
+}
+
+#endif
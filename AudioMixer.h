@@ -0,0 +1,94 @@
+// AudioMixer.h - sound effects mixed on their own thread, started from the game thread without waiting
+
+#ifndef AUDIOMIXER_HDR
+#define AUDIOMIXER_HDR
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "SpscQueue.h"
+#include "WavFile.h"
+
+class AudioSink;
+
+// Sounds are registered by addSound before start. One already in the mixer's
+// format (16-bit stereo at RATE), such as a mapped .wav or a baked pack entry,
+// is mixed in place with no copy; any other is converted once into a cache,
+// so the mixing thread only adds samples. A long track is added instead by
+// addStream: it stays a STREAMED WavFile that the mixing thread reads
+// STREAM_FRAMES at a time as its voice needs them, so its memory doesn't grow
+// with its length. A stream has one read position, so it has one voice:
+// playing it again restarts it, and it is never taken for another sound.
+// play is called on the game thread: it pushes a command on a wait-free
+// queue and returns, so a bomb taking out nine bricks costs nine pushes and
+// no locks. The mixing thread drains the queue once per BLOCK frames, gives
+// each command one of NVOICES voices (taking the oldest if all are busy),
+// mixes and hands the block to the sink, whose write paces the loop; a
+// command therefore sounds within one block plus the sink's buffering.
+
+struct Pcm {
+    int rate = 0, channels = 0;
+    std::vector<short> samples; // interleaved; empty if the file couldn't be decoded
+    int frames() const { return channels ? (int) samples.size() / channels : 0; }
+};
+
+bool DecodeWav(const char *filename, Pcm &pcm);
+    // read an uncompressed 16-bit .wav (streamed, via WavFile); on failure print a message and leave pcm empty
+bool DecodeMp3(const char *filename, Pcm &pcm);
+    // as DecodeWav, for an .mp3; uses Media Foundation, so elsewhere than Windows always fails
+bool DecodeSound(const char *filename, Pcm &pcm);
+    // DecodeMp3 if filename ends in .mp3, else DecodeWav
+
+void ConvertPcm(const short *samples, int frames, int channels, int rate, int outRate, std::vector<short> &stereo);
+    // interleaved 16-bit to stereo at outRate, with linear interpolation if the rates differ
+
+class AudioMixer {
+public:
+    enum { RATE = 44100, BLOCK = 256, NVOICES = 16, NCOMMANDS = 64 };
+    ~AudioMixer() { stop(); }
+    int addSound(const short *samples, int frames, int channels, int rate);
+        // before start: register interleaved 16-bit samples and return their id, or -1 if unusable;
+        // samples in the mixer's format are used in place, so must outlive the mixer
+    int addSound(const char *soundFile);
+        // as above, mapping a .wav if it's in the mixer's format, else decoding (see DecodeSound) and converting it
+    int addStream(const char *wavFile, bool loop = false);
+        // before start: register a 16-bit mono or stereo .wav at RATE to be streamed, and return its id, or -1
+    bool start(AudioSink *sink);
+        // open sink and start the mixing thread; return false if sink can't be opened
+    void stop();
+        // stop the thread and close the sink; queued and playing sounds are dropped
+    bool play(int sound, float gain = 1);
+        // game thread only: start sound without blocking; false if it isn't cached, the mixer isn't running or the queue is full
+    bool running() const { return thread.joinable(); }
+    std::atomic<int> dropped{0}; // plays lost to a full queue, or to every voice streaming
+    std::atomic<int> stolen{0};  // voices cut short to make room
+    std::atomic<long long> mixed{0}; // frames sent to the sink
+private:
+    struct Command { int sound; float gain; };
+    struct Voice { int sound = -1, position = 0; float gain = 0; };
+    struct Sound { const short *samples; int frames, stream; }; // stereo at RATE, or streams[stream] if stream >= 0
+    struct Stream {
+        std::unique_ptr<WavFile> file; // STREAMED
+        std::vector<short> buffer; // STREAM_FRAMES, in the file's channels
+        int buffered = 0, next = 0; // frames in buffer, next to mix
+        bool loop = false;
+    };
+    std::vector<Sound> sounds; // not changed while the thread runs
+    std::vector<std::vector<short>> converted; // storage for sounds not in the mixer's format
+    std::vector<std::unique_ptr<WavFile>> files; // mapped storage for .wav files already in the mixer's format
+    std::vector<Stream> streams; // read only by the mixing thread once it runs
+    SpscQueue<Command, NCOMMANDS> commands;
+    Voice voices[NVOICES];
+    AudioSink *sink = nullptr;
+    std::atomic<bool> quit{false};
+    std::thread thread;
+    void run();
+    Voice *findVoice(int sound);
+    void startVoice(const Command &c);
+    bool refill(Stream &s);
+    void mixStream(Voice &v, float *sum, int frames);
+    void mix(short *out, int frames);
+};
+
+#endif
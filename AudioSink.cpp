@@ -0,0 +1,146 @@
+// AudioSink.cpp - where AudioMixer sends its blocks: a sound device, a file or nowhere
+
+#include "AudioSink.h"
+#include <thread>
+
+// NullSink
+
+bool NullSink::open(int r, int /*blockFrames*/) {
+    rate = r;
+    frames = 0;
+    start = std::chrono::steady_clock::now();
+    return true;
+}
+
+void NullSink::write(const short * /*stereo*/, int n) {
+    frames += n;
+    if (realTime) // return when a device would have played all but this block
+        std::this_thread::sleep_until(start + std::chrono::microseconds((frames - n) * 1000000 / rate));
+}
+
+// WavFileSink
+
+namespace {
+
+void Put(FILE *out, int value, int bytes) {
+    for (int i = 0; i < bytes; i++)
+        fputc((value >> (8 * i)) & 255, out);
+}
+
+void PutHeader(FILE *out, int rate, long long frames) {
+    int dataBytes = (int) (4 * frames);
+    fwrite("RIFF", 1, 4, out);
+    Put(out, 36 + dataBytes, 4);
+    fwrite("WAVEfmt ", 1, 8, out);
+    Put(out, 16, 4);
+    Put(out, 1, 2);        // uncompressed
+    Put(out, 2, 2);        // stereo
+    Put(out, rate, 4);
+    Put(out, 4 * rate, 4); // bytes per second
+    Put(out, 4, 2);        // bytes per frame
+    Put(out, 16, 2);       // bits per sample
+    fwrite("data", 1, 4, out);
+    Put(out, dataBytes, 4);
+}
+
+} // end namespace
+
+bool WavFileSink::open(int r, int blockFrames) {
+    close();
+    out = fopen(filename, "wb");
+    if (!out) {
+        fprintf(stderr, "WavFileSink: can't write %s\n", filename);
+        return false;
+    }
+    PutHeader(out, r, 0); // sizes are patched by close
+    return NullSink::open(r, blockFrames);
+}
+
+void WavFileSink::write(const short *stereo, int n) {
+    for (int i = 0; i < 2 * n; i++) // little-endian whatever the host
+        Put(out, stereo[i], 2);
+    NullSink::write(stereo, n);
+}
+
+void WavFileSink::close() {
+    if (!out)
+        return;
+    fseek(out, 0, SEEK_SET);
+    PutHeader(out, rate, frames);
+    fclose(out);
+    out = nullptr;
+}
+
+#ifdef _WIN32
+
+// WaveOutSink
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <mmsystem.h>
+#include <string.h>
+#include <vector>
+
+struct WaveOutSink::Device {
+    HWAVEOUT waveOut = NULL;
+    HANDLE done = NULL; // signaled by the driver as each buffer finishes
+    WAVEHDR headers[NBUFFERS];
+    std::vector<short> buffers[NBUFFERS];
+    int next = 0;
+};
+
+bool WaveOutSink::open(int rate, int blockFrames) {
+    close();
+    device = new Device();
+    device->done = CreateEvent(NULL, FALSE, FALSE, NULL);
+    WAVEFORMATEX f = { WAVE_FORMAT_PCM, 2, (DWORD) rate, (DWORD) (4 * rate), 4, 16, 0 };
+    MMRESULT r = waveOutOpen(&device->waveOut, WAVE_MAPPER, &f, (DWORD_PTR) device->done, 0, CALLBACK_EVENT);
+    if (r != MMSYSERR_NOERROR) {
+        fprintf(stderr, "WaveOutSink: waveOutOpen failed (%u)\n", r);
+        device->waveOut = NULL;
+        close();
+        return false;
+    }
+    for (int i = 0; i < NBUFFERS; i++) {
+        device->buffers[i].resize(2 * blockFrames);
+        memset(&device->headers[i], 0, sizeof(WAVEHDR));
+        device->headers[i].dwFlags = WHDR_DONE; // free for the first write
+    }
+    return true;
+}
+
+void WaveOutSink::write(const short *stereo, int frames) {
+    // wait for the oldest buffer to play out, then refill and requeue it
+    int i = device->next;
+    WAVEHDR &h = device->headers[i];
+    while (!(h.dwFlags & WHDR_DONE))
+        WaitForSingleObject(device->done, INFINITE);
+    if (h.dwFlags & WHDR_PREPARED)
+        waveOutUnprepareHeader(device->waveOut, &h, sizeof(WAVEHDR));
+    std::vector<short> &b = device->buffers[i];
+    b.assign(stereo, stereo + 2 * frames);
+    memset(&h, 0, sizeof(WAVEHDR));
+    h.lpData = (LPSTR) b.data();
+    h.dwBufferLength = 4 * frames;
+    waveOutPrepareHeader(device->waveOut, &h, sizeof(WAVEHDR));
+    waveOutWrite(device->waveOut, &h, sizeof(WAVEHDR));
+    device->next = (i + 1) % NBUFFERS;
+}
+
+void WaveOutSink::close() {
+    if (!device)
+        return;
+    if (device->waveOut) {
+        waveOutReset(device->waveOut); // marks every queued buffer done
+        for (WAVEHDR &h : device->headers)
+            if (h.dwFlags & WHDR_PREPARED)
+                waveOutUnprepareHeader(device->waveOut, &h, sizeof(WAVEHDR));
+        waveOutClose(device->waveOut);
+    }
+    if (device->done)
+        CloseHandle(device->done);
+    delete device;
+    device = nullptr;
+}
+
+#endif
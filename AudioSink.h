@@ -0,0 +1,65 @@
+// AudioSink.h - where AudioMixer sends its blocks: a sound device, a file or nowhere
+
+#ifndef AUDIOSINK_HDR
+#define AUDIOSINK_HDR
+
+#include <chrono>
+#include <stdio.h>
+
+// A sink takes 16-bit interleaved stereo a block at a time. write blocks
+// until the destination has room, which is what paces the mixer: a device
+// sink holds only a few blocks, and so bounds the latency from play to sound.
+
+class AudioSink {
+public:
+    virtual ~AudioSink() { }
+    virtual bool open(int rate, int blockFrames) = 0;
+    virtual void write(const short *stereo, int frames) = 0;
+    virtual void close() { }
+};
+
+class NullSink : public AudioSink {
+public:
+    // discard the audio, taking as long as a device would to play it (for headless runs)
+    NullSink(bool realTime = true) : realTime(realTime) { }
+    bool open(int rate, int blockFrames);
+    void write(const short *stereo, int frames);
+    long long frames = 0; // written since open
+protected:
+    bool realTime;
+    int rate = 0;
+    std::chrono::steady_clock::time_point start;
+};
+
+class WavFileSink : public NullSink {
+public:
+    // record the audio to a 16-bit stereo .wav file; realTime false mixes as fast as possible
+    WavFileSink(const char *filename, bool realTime = true) : NullSink(realTime), filename(filename) { }
+    ~WavFileSink() { close(); }
+    bool open(int rate, int blockFrames);
+    void write(const short *stereo, int frames);
+    void close();
+private:
+    const char *filename;
+    FILE *out = nullptr;
+};
+
+#ifdef _WIN32
+
+class WaveOutSink : public AudioSink {
+public:
+    // play through the default device with NBUFFERS blocks queued, so at most
+    // NBUFFERS * blockFrames / rate seconds between mixing and hearing
+    enum { NBUFFERS = 4 };
+    ~WaveOutSink() { close(); }
+    bool open(int rate, int blockFrames);
+    void write(const short *stereo, int frames);
+    void close();
+private:
+    struct Device;
+    Device *device = nullptr;
+};
+
+#endif
+
+#endif
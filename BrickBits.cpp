@@ -0,0 +1,100 @@
+// BrickBits.cpp - brick field stored as per-row bitmasks
+
+#include "BrickBits.h"
+
+int PopCount(uint64_t v) {
+#if defined(_MSC_VER)
+    // __popcnt is the POPCNT instruction, which older CPUs lack; count bits in parallel instead
+    v -= (v >> 1) & 0x5555555555555555ull;
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (int) ((v * 0x0101010101010101ull) >> 56);
+#else
+    return __builtin_popcountll(v); // a library call unless built for a CPU with POPCNT
+#endif
+}
+
+void BrickBits::resize(int nRows, int nCols) {
+    rows = nRows;
+    cols = nCols;
+    words = (cols + 63) / 64;
+    rowMask.assign(words, ~0ull);
+    if (cols % 64)
+        rowMask[words - 1] = (1ull << (cols % 64)) - 1;
+    visible.resize(rows * words);
+    for (int r = 0; r < rows; r++)
+        for (int w = 0; w < words; w++)
+            visible[r * words + w] = rowMask[w];
+    bomb.assign(rows * words, 0);
+    bombZone.assign(rows * words, 0);
+    window.assign(words, 0);
+    live = rows * cols;
+}
+
+bool BrickBits::testBit(const std::vector<uint64_t> &plane, int i) const {
+    int row = i / cols, col = i % cols;
+    return (plane[row * words + col / 64] >> (col % 64)) & 1;
+}
+
+bool BrickBits::clearVisible(int i) {
+    int row = i / cols, col = i % cols;
+    uint64_t &w = visible[row * words + col / 64], bit = 1ull << (col % 64);
+    if (!(w & bit))
+        return false;
+    w &= ~bit;
+    live--;
+    return true;
+}
+
+void BrickBits::buildWindow(int col) {
+    // bits col-1, col, col+1 of a row: one bit spread by shifts, carried across word edges
+    int w = col / 64, b = col % 64;
+    uint64_t one = 1ull << b;
+    window[w] = one | one << 1 | one >> 1;
+    if (b == 63 && w + 1 < words) window[w + 1] = 1;
+    if (b == 0 && w > 0) window[w - 1] = 1ull << 63;
+    for (int k = w - 1; k <= w + 1; k++)
+        if (k >= 0 && k < words)
+            window[k] &= rowMask[k];
+}
+
+void BrickBits::placeBomb(int i) {
+    int row = i / cols, col = i % cols;
+    bomb[row * words + col / 64] |= 1ull << (col % 64);
+    buildWindow(col);
+    for (int r = row - 1; r <= row + 1; r++)
+        if (r >= 0 && r < rows)
+            for (int k = col / 64 - 1; k <= col / 64 + 1; k++)
+                if (k >= 0 && k < words)
+                    bombZone[r * words + k] |= window[k];
+    for (int k = col / 64 - 1; k <= col / 64 + 1; k++)
+        if (k >= 0 && k < words)
+            window[k] = 0;
+}
+
+int BrickBits::blast(int i, std::vector<int> &cleared) {
+    int row = i / cols, col = i % cols, nCleared = 0;
+    buildWindow(col);
+    for (int r = row - 1; r <= row + 1; r++) {
+        if (r < 0 || r >= rows)
+            continue;
+        for (int k = col / 64 - 1; k <= col / 64 + 1; k++) {
+            if (k < 0 || k >= words)
+                continue;
+            uint64_t m = window[k];
+            if (r == row && k == col / 64)
+                m &= ~(1ull << (col % 64)); // the bomb itself is the caller's to clear
+            uint64_t &v = visible[r * words + k];
+            uint64_t hit = v & m;
+            v &= ~hit;
+            nCleared += PopCount(hit);
+            for (; hit; hit &= hit - 1)
+                cleared.push_back(r * cols + k * 64 + PopCount((hit & (0 - hit)) - 1));
+        }
+    }
+    for (int k = col / 64 - 1; k <= col / 64 + 1; k++)
+        if (k >= 0 && k < words)
+            window[k] = 0;
+    live -= nCleared;
+    return nCleared;
+}
@@ -0,0 +1,40 @@
+// BrickBits.h - brick field stored as per-row bitmasks
+
+#ifndef BRICKBITS_HDR
+#define BRICKBITS_HDR
+
+#include <stdint.h>
+#include <vector>
+
+// Brick i = row * cols + col is bit col of row; a row spans (cols+63)/64 words,
+// so any width works. Bomb blasts and bomb spacing use 3x3 neighborhood masks
+// built by shifting and OR-ing, and the live count is kept current as bits clear.
+
+int PopCount(uint64_t v);
+
+class BrickBits {
+public:
+    void resize(int rows, int cols);
+        // all bricks visible, no bombs
+    bool isVisible(int i) const { return testBit(visible, i); }
+    bool isBomb(int i) const { return testBit(bomb, i); }
+    bool clearVisible(int i);
+        // return true if brick i was visible
+    bool canPlaceBomb(int i) const { return !testBit(bombZone, i); }
+        // true if no bomb is within the 3x3 neighborhood of i
+    void placeBomb(int i);
+    int blast(int i, std::vector<int> &cleared);
+        // clear visible bricks in the 3x3 neighborhood of i (excluding i), append their indices to cleared
+        // return the number cleared
+    int liveCount() const { return live; }
+        // number of visible bricks; zero means the level is complete
+private:
+    int rows = 0, cols = 0, words = 0, live = 0;
+    std::vector<uint64_t> visible, bomb, bombZone;
+    std::vector<uint64_t> rowMask; // valid bits of one row
+    std::vector<uint64_t> window; // scratch: 3-wide mask around a column
+    bool testBit(const std::vector<uint64_t> &plane, int i) const;
+    void buildWindow(int col);
+};
+
+#endif
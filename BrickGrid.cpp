@@ -0,0 +1,79 @@
+// BrickGrid.cpp - broadphase lookup of bricks near a rectangle
+
+#include "BrickGrid.h"
+#include "GameWorld.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+bool Near(float a, float b) { return fabs(a - b) < 1e-3f; }
+
+} // end namespace
+
+void BrickGrid::build(const std::vector<Brick> &bricks, int nRows, int nCols) {
+    rows = nRows;
+    cols = nCols;
+    cells.clear();
+    lattice = rows > 0 && cols > 0 && (int) bricks.size() == rows * cols;
+    if (lattice) {
+        // derive origin and pitch from the first row and column, then verify every brick
+        originX = bricks[0].x;
+        originY = bricks[0].y;
+        pitchX = cols > 1 ? bricks[1].x - originX : bricks[0].width;
+        pitchY = rows > 1 ? bricks[cols].y - originY : bricks[0].height;
+        lattice = pitchX >= bricks[0].width && pitchY >= bricks[0].height;
+        for (int i = 0; lattice && i < (int) bricks.size(); i++) {
+            const Brick &b = bricks[i];
+            int row = i / cols, col = i % cols;
+            lattice = Near(b.x, originX + col * pitchX) && Near(b.y, originY + row * pitchY) &&
+                      b.width <= pitchX && b.height <= pitchY;
+        }
+    }
+    if (lattice)
+        return;
+    // spatial hash: cells the size of the largest brick, each brick listed in every cell it touches
+    cellSize = 1;
+    for (const Brick &b : bricks)
+        cellSize = std::max(cellSize, std::max(b.width, b.height));
+    for (int i = 0; i < (int) bricks.size(); i++) {
+        const Brick &b = bricks[i];
+        int cx0 = (int) floor(b.x / cellSize), cx1 = (int) floor((b.x + b.width) / cellSize);
+        int cy0 = (int) floor(b.y / cellSize), cy1 = (int) floor((b.y + b.height) / cellSize);
+        for (int cy = cy0; cy <= cy1; cy++)
+            for (int cx = cx0; cx <= cx1; cx++)
+                cells[key(cx, cy)].push_back(i);
+    }
+}
+
+int BrickGrid::column(float x) const {
+    if (!lattice)
+        return -1;
+    int c = (int) floor((x - originX) / pitchX);
+    return c >= 0 && c < cols ? c : -1;
+}
+
+void BrickGrid::query(float x0, float y0, float x1, float y1, std::vector<int> &out) const {
+    out.clear();
+    if (lattice) {
+        // a brick occupies the leading part of its cell, so floor() finds every candidate
+        int c0 = std::max(0, (int) floor((x0 - originX) / pitchX));
+        int c1 = std::min(cols - 1, (int) floor((x1 - originX) / pitchX));
+        int r0 = std::max(0, (int) floor((y0 - originY) / pitchY));
+        int r1 = std::min(rows - 1, (int) floor((y1 - originY) / pitchY));
+        for (int r = r0; r <= r1; r++)
+            for (int c = c0; c <= c1; c++)
+                out.push_back(r * cols + c);
+        return;
+    }
+    int cx0 = (int) floor(x0 / cellSize), cx1 = (int) floor(x1 / cellSize);
+    int cy0 = (int) floor(y0 / cellSize), cy1 = (int) floor(y1 / cellSize);
+    for (int cy = cy0; cy <= cy1; cy++)
+        for (int cx = cx0; cx <= cx1; cx++) {
+            auto it = cells.find(key(cx, cy));
+            if (it != cells.end())
+                out.insert(out.end(), it->second.begin(), it->second.end());
+        }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
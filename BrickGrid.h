@@ -0,0 +1,32 @@
+// BrickGrid.h - broadphase lookup of bricks near a rectangle
+
+#ifndef BRICKGRID_HDR
+#define BRICKGRID_HDR
+
+#include <vector>
+#include <unordered_map>
+
+struct Brick;
+
+// Bricks never move, so the index is built once per level. A field laid out
+// as row * cols + col on a regular pitch (as setupBricks makes) is queried by
+// direct cell arithmetic; any other layout falls back to a uniform spatial hash.
+
+class BrickGrid {
+public:
+    void build(const std::vector<Brick> &bricks, int rows, int cols);
+    void query(float x0, float y0, float x1, float y1, std::vector<int> &out) const;
+        // replace out with the indices, ascending, of bricks whose bounds may overlap [x0,x1]x[y0,y1]
+    int column(float x) const;
+        // lattice column whose cell spans x, or -1 if none (always -1 for non-lattice layouts)
+    bool isLattice() const { return lattice; }
+private:
+    bool lattice = false;
+    int rows = 0, cols = 0;
+    float originX = 0, originY = 0, pitchX = 1, pitchY = 1;
+    float cellSize = 1; // spatial hash fallback
+    std::unordered_map<long long, std::vector<int>> cells;
+    static long long key(int cx, int cy) { return ((long long) cx << 32) ^ (unsigned int) cy; }
+};
+
+#endif
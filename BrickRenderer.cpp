@@ -0,0 +1,170 @@
+// BrickRenderer.cpp - whole brick field in one instanced draw from an array texture
+
+#include <glad.h>
+#include <GLFW/glfw3.h>
+#include "Atlas.h"
+#include "BrickRenderer.h"
+#include "GameWorld.h"
+#include "FrameUniforms.h"
+#include "GLState.h"
+#include "GLXtras.h"
+#include "ImageLoader.h"
+#include <stdio.h>
+#include <algorithm>
+
+namespace {
+
+const int LAYER_WIDTH = 256, LAYER_HEIGHT = 128; // bricks are 58x20; mipmaps cover the rest
+const int MERGE_GAP = 8; // clean instances worth re-sending to save a glBufferSubData call
+
+const char *vertexShader = R"(
+    #version 330
+    layout (location = 0) in vec4 rect;   // per instance: x, y, width, height in pixels
+    layout (location = 1) in float layer; // per instance: array texture layer, or -1 if not drawn
+    layout (std140) uniform Frame { vec2 screen; }; // FrameUniforms, updated once per frame
+    out vec3 uvw;
+    void main() {
+        vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1); // 4-vertex strip
+        vec2 p = rect.xy + (layer < 0 ? vec2(0) : corner * rect.zw); // a dead brick's quad collapses to a point
+        gl_Position = vec4(2 * p.x / screen.x - 1, 1 - 2 * p.y / screen.y, 0, 1);
+        uvw = vec3(corner, layer);
+    }
+)";
+
+const char *pixelShader = R"(
+    #version 330
+    in vec3 uvw;
+    out vec4 pColor;
+    uniform sampler2DArray bricks;
+    void main() {
+        pColor = texture(bricks, uvw);
+    }
+)";
+
+} // end namespace
+
+bool BrickRenderer::init(const Image *layers[NLAYERS]) {
+    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress) || !GLAD_GL_VERSION_3_3) {
+        printf("BrickRenderer: OpenGL 3.3 unavailable\n");
+        return false;
+    }
+    glGenTextures(1, &textureArray);
+    BindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, LAYER_WIDTH, LAYER_HEIGHT, NLAYERS, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    std::vector<unsigned char> layer(LAYER_WIDTH * LAYER_HEIGHT * 4);
+    for (int i = 0; i < NLAYERS; i++) {
+        const Image &image = *layers[i];
+        if (image.pixels.empty()) {
+            printf("BrickRenderer: no image for layer %d\n", i);
+            DeleteTextures(1, &textureArray);
+            textureArray = 0;
+            return false;
+        }
+        ResampleRGBA(image.pixels.data(), image.width, image.height, layer.data(), LAYER_WIDTH, LAYER_HEIGHT);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, LAYER_WIDTH, LAYER_HEIGHT, 1, GL_RGBA, GL_UNSIGNED_BYTE, layer.data());
+    }
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    return createProgram();
+}
+
+bool BrickRenderer::init(const unsigned char *levels, int layerWidth, int layerHeight, int nLevels) {
+    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress) || !GLAD_GL_VERSION_3_3) {
+        printf("BrickRenderer: OpenGL 3.3 unavailable\n");
+        return false;
+    }
+    // each level is already resampled, so this is one upload per level and no glGenerateMipmap
+    glGenTextures(1, &textureArray);
+    BindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, nLevels - 1);
+    for (int level = 0; level < nLevels; level++) {
+        int w = std::max(1, layerWidth >> level), h = std::max(1, layerHeight >> level);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, w, h, NLAYERS, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels);
+        levels += w * h * 4 * NLAYERS;
+    }
+    return createProgram();
+}
+
+bool BrickRenderer::createProgram() {
+    // texture array is bound; finish its state, then build the program and instance buffer
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    program = LinkProgramViaCode(&vertexShader, &pixelShader);
+    if (!program)
+        return false;
+    FrameUniforms::attach(program);
+    UseProgram(program);
+    SetUniform(program, "bricks", 0); // texture unit, fixed for the program's life
+    glGenVertexArrays(1, &vao);
+    BindVertexArray(vao);
+    glGenBuffers(1, &instanceBuffer);
+    BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void *) 0);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(Instance), (void *) (4 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(0, 1);
+    glVertexAttribDivisor(1, 1);
+    BindVertexArray(0);
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+    UseProgram(0);
+    return true;
+}
+
+float BrickRenderer::layerOf(const Brick &b) {
+    if (!b.isVisible || (!b.isBomb && (b.hitsRemaining < 1 || b.hitsRemaining > 3)))
+        return -1;
+    return (float) (b.isBomb ? BOMB : STAGE1 + b.hitsRemaining - 1);
+}
+
+void BrickRenderer::sync(const std::vector<Brick> &bricks, int layout, std::vector<int> &changed) {
+    uploadBytes = 0;
+    if (!program) {
+        changed.clear();
+        return;
+    }
+    BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    if (layout != builtLayout || bricks.size() != instances.size()) {
+        // new level: one instance per brick slot, sent whole
+        instances.resize(bricks.size());
+        for (size_t i = 0; i < bricks.size(); i++) {
+            const Brick &b = bricks[i];
+            instances[i] = { b.x, b.y, b.width, b.height, layerOf(b) };
+        }
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(Instance), instances.data(), GL_STATIC_DRAW);
+        uploadBytes = (int) (instances.size() * sizeof(Instance));
+        builtLayout = layout;
+    }
+    else if (!changed.empty()) {
+        // rewrite changed slots, sending runs that are close together as one range
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+        for (size_t i = 0; i < changed.size(); ) {
+            int first = changed[i], last = first;
+            for (; i < changed.size() && changed[i] - last <= MERGE_GAP; i++) {
+                last = changed[i];
+                instances[last].layer = layerOf(bricks[last]);
+            }
+            GLsizeiptr bytes = (last - first + 1) * sizeof(Instance);
+            glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Instance), bytes, &instances[first]);
+            uploadBytes += (int) bytes;
+        }
+    }
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+    changed.clear();
+}
+
+void BrickRenderer::draw() {
+    if (!program || instances.empty())
+        return;
+    UseProgram(program);
+    ActiveTexture(GL_TEXTURE0);
+    BindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+    BindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei) instances.size());
+    BindVertexArray(0);
+    BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    UseProgram(0);
+}
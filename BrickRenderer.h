@@ -0,0 +1,43 @@
+// BrickRenderer.h - whole brick field in one instanced draw from an array texture
+
+#ifndef BRICKRENDERER_HDR
+#define BRICKRENDERER_HDR
+
+#include <vector>
+
+struct Brick;
+struct Image;
+
+// Each brick texture (stage1-3 and bomb) is resampled into one layer of a
+// 2D array texture, and each brick slot is one instance (rect, layer), so the
+// field costs one bind and one draw instead of a bind and a glBegin/glEnd per
+// brick. The instances live in a GPU buffer written whole once per level;
+// after that only the slots GameWorld reports as changed are rewritten, so a
+// frame with no hits uploads nothing. Needs OpenGL 3.3; init fails (and the
+// caller should keep drawing bricks in immediate mode) on older contexts.
+
+class BrickRenderer {
+public:
+    enum Layer { STAGE1, STAGE2, STAGE3, BOMB, NLAYERS };
+    bool init(const Image *layers[NLAYERS]);
+        // call once with a current GL context and the decoded layer images; return false if GL 3.3 or an image is unavailable
+    bool init(const unsigned char *levels, int layerWidth, int layerHeight, int nLevels);
+        // as above, from a mip chain baked into an AssetPack (level by level, each level all NLAYERS layers)
+    void sync(const std::vector<Brick> &bricks, int layout, std::vector<int> &changed);
+        // bring the GPU copy up to date: rebuild it if layout (GameWorld::brickLayout) differs from the
+        // last sync, else rewrite the bricks listed in changed (GameWorld::changedBricks); clears changed
+    void draw();
+        // draw bricks as of the last sync in pixel coordinates, y down, at the FrameUniforms screen size;
+        // leaves no program or vertex array bound
+    bool ready() const { return program != 0; }
+    int uploadBytes = 0; // sent to the GPU by the last sync
+private:
+    unsigned int program = 0, vao = 0, instanceBuffer = 0, textureArray = 0;
+    struct Instance { float x, y, w, h, layer; };
+    std::vector<Instance> instances; // CPU mirror of the buffer, one per brick slot
+    int builtLayout = -1;
+    static float layerOf(const Brick &b);
+    bool createProgram();
+};
+
+#endif
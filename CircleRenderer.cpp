@@ -0,0 +1,102 @@
+// CircleRenderer.cpp - balls, bullets and power-ups as instanced analytic discs
+
+#include <glad.h>
+#include <GLFW/glfw3.h>
+#include "Atlas.h"
+#include "CircleRenderer.h"
+#include "FrameUniforms.h"
+#include "GLState.h"
+#include "GLXtras.h"
+#include <stdio.h>
+
+namespace {
+
+const char *vertexShader = R"(
+    #version 330
+    layout (location = 0) in vec3 circle;   // per instance: center x, y and radius in pixels
+    layout (location = 1) in vec4 uvRect;   // per instance: sprite u0, v0, u1, v1
+    layout (location = 2) in vec4 tint;     // per instance: rgb, and 1 if textured
+    layout (std140) uniform Frame { vec2 screen; }; // FrameUniforms, updated once per frame
+    out vec2 local, uv;
+    out vec4 vTint;
+    void main() {
+        local = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2 - 1; // 4-vertex strip over [-1, 1]^2
+        vec2 p = circle.xy + circle.z * local;
+        gl_Position = vec4(2 * p.x / screen.x - 1, 1 - 2 * p.y / screen.y, 0, 1);
+        uv = mix(uvRect.xy, uvRect.zw, local * .5 + .5);
+        vTint = tint;
+    }
+)";
+
+const char *pixelShader = R"(
+    #version 330
+    in vec2 local, uv;
+    in vec4 vTint;
+    out vec4 pColor;
+    uniform sampler2D sprites;
+    void main() {
+        if (dot(local, local) > 1)
+            discard;
+        vec4 texel = vTint.a > 0 ? texture(sprites, uv) : vec4(1);
+        pColor = vec4(vTint.rgb, 1) * texel;
+    }
+)";
+
+} // end namespace
+
+bool CircleRenderer::init() {
+    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress) || !GLAD_GL_VERSION_3_3) {
+        printf("CircleRenderer: OpenGL 3.3 unavailable\n");
+        return false;
+    }
+    program = LinkProgramViaCode(&vertexShader, &pixelShader);
+    if (!program)
+        return false;
+    FrameUniforms::attach(program);
+    UseProgram(program);
+    SetUniform(program, "sprites", 0); // texture unit, fixed for the program's life
+    glGenVertexArrays(1, &vao);
+    BindVertexArray(vao);
+    glGenBuffers(1, &instanceBuffer);
+    BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void *) 0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void *) (3 * sizeof(float)));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void *) (7 * sizeof(float)));
+    for (int i = 0; i < 3; i++) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 1);
+    }
+    BindVertexArray(0);
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+    UseProgram(0);
+    return true;
+}
+
+void CircleRenderer::add(float x, float y, float radius, const AtlasRect *sprite, float r, float g, float b) {
+    if (sprite)
+        instances.push_back({ x, y, radius, sprite->u0, sprite->v0, sprite->u1, sprite->v1, r, g, b, 1 });
+    else
+        instances.push_back({ x, y, radius, 0, 0, 0, 0, r, g, b, 0 });
+}
+
+void CircleRenderer::draw(unsigned int texture) {
+    if (!program || instances.empty()) {
+        instances.clear();
+        return;
+    }
+    BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    if ((int) instances.size() > capacity) {
+        capacity = 2 * (int) instances.size();
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Instance), NULL, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(Instance), instances.data());
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+    UseProgram(program);
+    ActiveTexture(GL_TEXTURE0);
+    BindTexture(GL_TEXTURE_2D, texture);
+    BindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei) instances.size());
+    BindVertexArray(0);
+    UseProgram(0);
+    instances.clear();
+}
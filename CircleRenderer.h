@@ -0,0 +1,32 @@
+// CircleRenderer.h - balls, bullets and power-ups as instanced analytic discs
+
+#ifndef CIRCLERENDERER_HDR
+#define CIRCLERENDERER_HDR
+
+#include <vector>
+
+struct AtlasRect;
+
+// Every circle is one instance (center, radius, sprite rect, tint) of a single
+// screen-aligned quad; the pixel shader keeps the fragments inside the disc, so
+// there is no per-vertex trig and no tessellation. Circles are collected with
+// add during the frame and drawn together by draw. Needs OpenGL 3.3.
+
+class CircleRenderer {
+public:
+    bool init();
+        // call once with a current GL context; return false if GL 3.3 is unavailable
+    bool ready() const { return program != 0; }
+    void add(float x, float y, float radius, const AtlasRect *sprite, float r = 1, float g = 1, float b = 1);
+        // queue a disc in pixel coordinates, y down; sprite (a rect of the texture passed to draw) or null for flat tint
+    void draw(unsigned int texture);
+        // draw all queued discs in one call at the FrameUniforms screen size and empty the queue;
+        // leaves no program or vertex array bound
+private:
+    unsigned int program = 0, vao = 0, instanceBuffer = 0;
+    struct Instance { float x, y, radius, u0, v0, u1, v1, r, g, b, textured; };
+    std::vector<Instance> instances;
+    int capacity = 0; // instances the buffer holds
+};
+
+#endif
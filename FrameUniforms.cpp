@@ -0,0 +1,36 @@
+// FrameUniforms.cpp - per-frame values shared by the renderers' shaders, in one uniform buffer
+
+#include <glad.h>
+#include <GLFW/glfw3.h>
+#include "FrameUniforms.h"
+#include "GLState.h"
+#include <stdio.h>
+
+void FrameUniforms::attach(unsigned int program) {
+    GLuint index = glGetUniformBlockIndex(program, "Frame");
+    if (index != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, index, BINDING);
+}
+
+bool FrameUniforms::init() {
+    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress) || !GLAD_GL_VERSION_3_3) {
+        printf("FrameUniforms: OpenGL 3.3 unavailable\n");
+        return false;
+    }
+    glGenBuffers(1, &buffer);
+    BindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), &block, GL_DYNAMIC_DRAW);
+    BindBufferBase(GL_UNIFORM_BUFFER, BINDING, buffer); // stays bound: nothing else uses BINDING
+    BindBuffer(GL_UNIFORM_BUFFER, 0);
+    return true;
+}
+
+void FrameUniforms::update(int screenWidth, int screenHeight) {
+    if (!buffer || (block.screen[0] == screenWidth && block.screen[1] == screenHeight))
+        return;
+    block.screen[0] = (float) screenWidth;
+    block.screen[1] = (float) screenHeight;
+    BindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+    BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
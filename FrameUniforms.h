@@ -0,0 +1,28 @@
+// FrameUniforms.h - per-frame values shared by the renderers' shaders, in one uniform buffer
+
+#ifndef FRAMEUNIFORMS_HDR
+#define FRAMEUNIFORMS_HDR
+
+// Each renderer's vertex shader declares
+//     layout (std140) uniform Frame { vec2 screen; };
+// and attaches the block to BINDING once, after linking. The game updates the
+// buffer once per frame, so no renderer sets the screen size per draw, and a
+// frame in which nothing changed sends nothing. Needs OpenGL 3.3.
+
+class FrameUniforms {
+public:
+    static const unsigned int BINDING = 0;
+    static void attach(unsigned int program);
+        // point program's Frame block at BINDING; call once after linking
+    bool init();
+        // call once with a current GL context; return false if GL 3.3 is unavailable
+    bool ready() const { return buffer != 0; }
+    void update(int screenWidth, int screenHeight);
+        // call once per frame before drawing; rewrites the buffer only if a value changed
+private:
+    struct Block { float screen[2], pad[2]; }; // std140 layout of Frame
+    Block block = {};
+    unsigned int buffer = 0;
+};
+
+#endif
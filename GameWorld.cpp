@@ -0,0 +1,605 @@
+// GameWorld.cpp - headless brick breaker simulation
+
+#include "GameWorld.h"
+#include "Sweep.h"
+#include "Trace.h"
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+
+// Ball
+
+Ball::Ball() : x(SCREEN_WIDTH / 2), y(SCREEN_HEIGHT - 50), dx(0.4f), dy(-0.4f), radius(BALL_RADIUS), idle(true), isFireball(false), hasGun(false), gunAmmo(0) {
+    normalizeVelocity();
+}
+
+void Ball::normalizeVelocity() {
+    float length = sqrt(dx * dx + dy * dy);
+    dx = (dx / length) * BALL_SPEED_L2;
+    dy = (dy / length) * BALL_SPEED_L2;
+}
+
+void Ball::setSpeed(float speed) {
+    float length = sqrt(dx * dx + dy * dy);
+    dx = (dx / length) * speed;
+    dy = (dy / length) * speed;
+}
+
+void Ball::applyPowerUp(float multiplier) {
+    dx *= multiplier;
+    dy *= multiplier;
+}
+
+void Ball::resetPowerUp() {
+    isFireball = false;
+    hasGun = false;
+    gunAmmo = 0;
+    normalizeVelocity();
+}
+
+// Rng
+
+uint32_t Rng::next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (uint32_t) ((z ^ (z >> 31)) >> 32);
+}
+
+void Rng::shuffle(std::vector<int> &v) {
+    for (int i = (int) v.size() - 1; i > 0; --i)
+        std::swap(v[i], v[below(i + 1)]);
+}
+
+// Level Setup
+
+void GameWorld::setupBricks() {
+    float startX = (SCREEN_WIDTH - (cols * (BRICK_WIDTH + BRICK_SPACING))) / 2.0f;
+    float startY = 50;
+    int bombCount = 0;
+    int maxBombs;
+
+    int totalBricks = rows * cols;
+    int fireballCount, gunCount, flipCount, shrinkCount;
+
+    switch (level) {
+    case 1:
+        fireballCount = totalBricks * 0.20; // 20% Fireball power-ups
+        gunCount = 0;
+        flipCount = 0;
+        shrinkCount = 0;
+        maxBombs = 8 + rng.below(2); // 8-9 bombs
+        break;
+    case 2:
+        fireballCount = totalBricks * 0.15; // 15% Fireball power-ups
+        shrinkCount = totalBricks * 0.15; // 15% Shrink power-ups
+        gunCount = totalBricks * 0.10; // 10% Gun power-ups
+        flipCount = 0;
+        maxBombs = 3 + rng.below(2); // 3-4 bombs
+        break;
+    case 3:
+        fireballCount = totalBricks * 0.10; // 10% Fireball power-ups
+        shrinkCount = totalBricks * 0.10; // 10% Shrink power-ups
+        gunCount = totalBricks * 0.10; // 10% Gun power-ups
+        flipCount = totalBricks * 0.10; // 10% Flip power-ups
+        maxBombs = 2 + rng.below(2); // 2-3 bombs
+        break;
+    default:
+        fireballCount = 0;
+        gunCount = 0;
+        flipCount = 0;
+        shrinkCount = 0;
+        maxBombs = 0;
+    }
+
+    std::vector<int> brickIndices(totalBricks);
+    for (int i = 0; i < totalBricks; ++i) {
+        brickIndices[i] = i;
+    }
+    rng.shuffle(brickIndices);
+
+    auto assignPowerUps = [&](int& count, PowerUpType type) {
+        while (count > 0) {
+            int index = brickIndices.back();
+            brickIndices.pop_back();
+            bricks[index].hasPowerUp = true;
+            bricks[index].powerUpType = type;
+            --count;
+        }
+        };
+
+    bricks.reserve(totalBricks);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            int type;
+
+            switch (level) {
+            case 1:
+                type = (rng.below(100) < 25) ? 2 : 1; // 25% 2-hit bricks, rest 1-hit bricks
+                break;
+            case 2:
+            {
+                int randVal = rng.below(100);
+                if (randVal < 30) {
+                    type = 2; // 30% 2-hit bricks
+                }
+                else if (randVal < 40) {
+                    type = 3; // 10% 3-hit bricks
+                }
+                else {
+                    type = 1; // rest 1-hit bricks
+                }
+            }
+            break;
+            case 3:
+            {
+                int randVal = rng.below(100);
+                if (randVal < 30) {
+                    type = 3; // 30% 3-hit bricks
+                }
+                else if (randVal < 70) {
+                    type = 2; // 40% 2-hit bricks
+                }
+                else {
+                    type = 1; // rest 1-hit bricks
+                }
+            }
+            break;
+            default:
+                type = 1;
+            }
+
+            bricks.emplace_back(startX + j * (BRICK_WIDTH + BRICK_SPACING), startY + i * (BRICK_HEIGHT + BRICK_SPACING), BRICK_WIDTH, BRICK_HEIGHT, type, false, FIREBALL, false);
+        }
+    }
+
+    // Place bombs ensuring they are not adjacent
+    std::vector<int> availableIndices;
+    for (int i = 0; i < totalBricks; ++i) {
+        availableIndices.push_back(i);
+    }
+    rng.shuffle(availableIndices);
+
+    field.resize(rows, cols);
+    while (bombCount < maxBombs && !availableIndices.empty()) {
+        int index = availableIndices.back();
+        availableIndices.pop_back();
+
+        // The field marks every cell next to a placed bomb, so adjacency is one bit test
+        if (field.canPlaceBomb(index)) {
+            field.placeBomb(index);
+            bricks[index].isBomb = true;
+            bombCount++;
+        }
+    }
+
+    assignPowerUps(fireballCount, FIREBALL);
+    assignPowerUps(gunCount, GUN);
+    assignPowerUps(flipCount, FLIP);
+    assignPowerUps(shrinkCount, SHRINK); // Assign the SHRINK power-up
+
+    grid.build(bricks, rows, cols);
+    lowestRow.assign(cols, rows - 1);
+    brickLayout++;
+    changedBricks.clear(); // the new layout supersedes them
+}
+
+void GameWorld::startLevel() {
+    bricks.clear();
+    powerUps.clear();
+    bullets.clear();
+    setupBricks();
+    ball = Ball();
+    paddle = Paddle();
+    aimAngle = PI / 6; // Reset aim angle
+    bricksBroken = 0; // Reset the count of bricks broken
+
+    // Set initial movement for the ball
+    ball.dx = 0.4f;
+    ball.dy = -0.4f;
+    ball.idle = true; // Ensure the ball is idle and waiting for the player to start
+    state = AIM;
+    timers.clear(); // Fresh ball and paddle, so nothing left to expire
+    fireballTimer = 0;
+}
+
+void GameWorld::reset(int startLevel, int nRows, int nCols) {
+    level = startLevel;
+    rows = nRows;
+    cols = nCols;
+    score = 0;
+    lives = 1; // Reset lives to 1
+    tick = 0;
+    this->startLevel();
+}
+
+void GameWorld::nextLevel() {
+    level++;
+    startLevel();
+}
+
+// Collisions
+
+void GameWorld::killBrick(int index) {
+    field.clearVisible(index);
+    bricks[index].isVisible = false;
+    changedBricks.push_back(index);
+    liftColumn(index);
+    breaks++;
+}
+
+void GameWorld::liftColumn(int index) {
+    // If index was its column's lowest live brick, walk up to the next live one;
+    // each row is passed at most once per level, so the cost is amortized O(1)
+    int col = index % cols, &row = lowestRow[col];
+    if (row != index / cols)
+        return;
+    while (row >= 0 && !field.isVisible(row * cols + col))
+        row--;
+}
+
+void GameWorld::destroySurroundingBricks(int bombIndex) {
+    cleared.clear();
+    score += 10 * field.blast(bombIndex, cleared);
+    breaks += (int) cleared.size();
+    blasts++;
+    for (int index : cleared) {
+        bricks[index].isVisible = false;
+        changedBricks.push_back(index);
+        liftColumn(index);
+    }
+}
+
+void GameWorld::hitBrick(int i, float nx, float ny) {
+    auto& brick = bricks[i];
+    if (brick.isBomb) {
+        destroySurroundingBricks(i);
+        killBrick(i);
+        score += 10;
+        bricksBroken++;
+    }
+    else if (ball.isFireball) {
+        killBrick(i);
+        score += 10; // Score for destroying brick
+        bricksBroken++;
+        if (brick.hasPowerUp) {
+            powerUps.emplace_back(brick.x + brick.width / 2, brick.y + brick.height / 2, 0.0f, 0.05f, brick.powerUpType); // Adjust the dy value to 0.05f for slower falling speed
+        }
+    }
+    else {
+        brick.hitsRemaining--;
+        changedBricks.push_back(i);
+        if (brick.hitsRemaining <= 0) {
+            killBrick(i);
+            score += 10; // Score for destroying brick
+            bricksBroken++;
+            if (brick.hasPowerUp) {
+                powerUps.emplace_back(brick.x + brick.width / 2, brick.y + brick.height / 2, 0.0f, 0.05f, brick.powerUpType); // Adjust the dy value to 0.05f for slower falling speed
+            }
+        }
+
+        // Reflect ball about the contact normal (a face normal flips dx or dy)
+        float vn = ball.dx * nx + ball.dy * ny;
+        ball.dx -= 2 * vn * nx;
+        ball.dy -= 2 * vn * ny;
+
+        ball.normalizeVelocity(); // Ensure ball doesn't change speed after collision
+    }
+
+    // Increase ball speed based on level and number of bricks broken
+    if (level == 2 && bricksBroken % 20 == 0) {
+        ball.setSpeed(ball.dx * 1.1f);
+    }
+    else if (level == 3 && bricksBroken % 15 == 0) {
+        ball.setSpeed(ball.dx * 1.1f);
+    }
+}
+
+void GameWorld::sweepBall() {
+    // Move the ball through one tick, stopping at each brick contact in time order
+    float remaining = 1.0f; // fraction of the tick still to travel
+    for (int contacts = 0; remaining > 0; contacts++) {
+        float mx = ball.dx * remaining, my = ball.dy * remaining;
+        int hitIndex = -1;
+        SweepHit best = { 2, 0, 0 }, hit;
+        if (contacts < MAX_BALL_CONTACTS) {
+            // Visit only bricks under the swept bounds of the rest of the move
+            grid.query(std::min(ball.x, ball.x + mx) - ball.radius, std::min(ball.y, ball.y + my) - ball.radius,
+                       std::max(ball.x, ball.x + mx) + ball.radius, std::max(ball.y, ball.y + my) + ball.radius, candidates);
+            for (int i : candidates) {
+                const Brick& b = bricks[i];
+                if (b.isVisible && sweepCircleBox(ball.x, ball.y, mx, my, ball.radius, b.x, b.y, b.x + b.width, b.y + b.height, hit) && hit.t < best.t) {
+                    best = hit;
+                    hitIndex = i;
+                }
+            }
+        }
+        if (hitIndex < 0) {
+            ball.x += mx;
+            ball.y += my;
+            break;
+        }
+        ball.x += mx * best.t;
+        ball.y += my * best.t;
+        remaining *= 1 - best.t;
+        hitBrick(hitIndex, best.nx, best.ny);
+    }
+}
+
+int GameWorld::bulletTarget(const Bullet& bullet) {
+    // Return the live brick containing the bullet, or -1
+    auto inside = [&bullet](const Brick& b) {
+        return b.isVisible && bullet.x > b.x && bullet.x < b.x + b.width && bullet.y > b.y && bullet.y < b.y + b.height;
+    };
+    int col = grid.column(bullet.x);
+    if (col >= 0) {
+        // Bullets rise at constant x from below the field, so the first brick they can
+        // meet is the lowest live one in their column
+        int row = lowestRow[col];
+        if (row < 0)
+            return -1;
+        const Brick& brick = bricks[row * cols + col];
+        if (bullet.y > brick.y)
+            return inside(brick) ? row * cols + col : -1;
+    }
+    // Above the lowest brick or off the lattice: look up the bullet's position
+    grid.query(bullet.x, bullet.y, bullet.x, bullet.y, candidates);
+    for (int i : candidates)
+        if (inside(bricks[i]))
+            return i;
+    return -1;
+}
+
+void GameWorld::checkCollisions() {
+    TRACE_ZONE("checkCollisions");
+    // Check bullet and brick collisions
+    for (auto& bullet : bullets) {
+        if (!bullet.active) continue;
+        int i = bulletTarget(bullet);
+        if (i >= 0) {
+            killBrick(i);
+            bullet.active = false;
+            score += 50; // Score for destroying brick with Gun
+            bricksBroken++;
+        }
+    }
+
+    // Check ball and paddle collisions
+    if (ball.y + ball.radius >= paddle.y && ball.y - ball.radius <= paddle.y + paddle.height &&
+        ball.x + ball.radius >= paddle.x && ball.x - ball.radius <= paddle.x + paddle.width) {
+        ball.dy = -fabs(ball.dy); // Always reflect the ball upward
+
+        // Adjust the ball's horizontal direction based on where it hits the paddle
+        float hitPos = (ball.x - paddle.x) / paddle.width;
+        ball.dx = (hitPos - 0.5f) * 2 * BALL_SPEED_L1;
+
+        ball.normalizeVelocity(); // Keep the ball speed constant after collision
+    }
+
+    // Wall collisions
+    if (ball.x - ball.radius < 0 || ball.x + ball.radius > SCREEN_WIDTH) {
+        ball.dx = -ball.dx; // Bounce off left and right walls
+        ball.normalizeVelocity(); // Keep the ball speed constant after collision
+    }
+    if (ball.y - ball.radius < 0) {
+        ball.dy = -ball.dy; // Bounce off top wall
+        ball.normalizeVelocity(); // Keep the ball speed constant after collision
+    }
+    if (ball.y + ball.radius > SCREEN_HEIGHT) {
+        // Ball goes out of bounds
+
+        if (lives > 0) {
+            resetAfterLifeLost = true;
+            ball.idle = true;
+            ball.x = SCREEN_WIDTH / 2; // Reset ball position
+            ball.y = SCREEN_HEIGHT - 50;
+            ball.dx = 0.4f; // Reset ball speed
+            ball.dy = -0.4f;
+            paddle.x = (SCREEN_WIDTH - PADDLE_WIDTH) / 2; // Reset paddle position
+            state = AIM; // Set game state to AIM to show aiming line
+        }
+        else {
+            state = GAME_OVER;
+        }
+        lives--;
+    }
+}
+
+bool GameWorld::checkPowerUpCollision(PowerUp& powerUp) {
+    if (powerUp.active) {
+        // Check collision with paddle
+        if (powerUp.y + powerUp.radius >= paddle.y && powerUp.x >= paddle.x && powerUp.x <= paddle.x + paddle.width) {
+            // Apply power-up effect
+            if (powerUp.type == FIREBALL) { // Fireball power-up
+                ball.isFireball = true;
+                ball.hasGun = false; // Deactivate Gun power-up
+                ball.gunAmmo = 0;
+                timers.cancel(fireballTimer); // A second fireball restarts the duration
+                fireballTimer = timers.schedule(tick + FIREBALL_DURATION * SIM_HZ, FIREBALL_EXPIRED);
+            }
+            else if (powerUp.type == GUN) { // Gun power-up
+                ball.hasGun = true;
+                ball.isFireball = false; // Deactivate Fireball power-up
+                ball.gunAmmo = 3;
+            }
+            else if (powerUp.type == FLIP) { // Flip power-up
+                paddle.controlsFlipped = !paddle.controlsFlipped;
+            }
+            else if (powerUp.type == SHRINK) { // Shrink power-up
+                if (!paddle.isShrunk) {
+                    paddle.width *= SHRINK_FACTOR;
+                    paddle.isShrunk = true;
+                    timers.schedule(tick + SHRINK_DURATION * SIM_HZ, SHRINK_EXPIRED);
+                }
+            }
+            powerUp.active = false; // Deactivate power-up
+            return true; // Collision detected
+        }
+    }
+    return false; // No collision
+}
+
+// Updates
+
+void GameWorld::updateBall() {
+    TRACE_ZONE("updateBall");
+    if (!ball.idle) {
+        sweepBall();
+        checkCollisions();
+    }
+
+    if (ball.y > paddle.y + paddle.height) {
+        // Ball goes out of bounds
+        lives--;
+        if (lives > 0) {
+            resetAfterLifeLost = true;
+            ball.idle = true;
+            ball.x = SCREEN_WIDTH / 2; // Reset ball position
+            ball.y = SCREEN_HEIGHT - 50;
+            ball.dx = 0.4f; // Reset ball speed
+            ball.dy = -0.4f;
+            paddle.x = (SCREEN_WIDTH - PADDLE_WIDTH) / 2; // Reset paddle position
+            paddle.moveLeft = false; // Reset paddle movement flags
+            paddle.moveRight = false; // Reset paddle movement flags
+            state = AIM; // Set game state to AIM to show aiming line
+        }
+        else {
+            state = GAME_OVER;
+        }
+    }
+}
+
+void GameWorld::onTimer(int event) {
+    if (event == FIREBALL_EXPIRED) {
+        fireballTimer = 0;
+        if (ball.isFireball) {
+            ball.isFireball = false;
+            ball.resetPowerUp();
+        }
+    }
+    else if (event == SHRINK_EXPIRED) {
+        paddle.width = PADDLE_WIDTH;
+        paddle.isShrunk = false;
+    }
+}
+
+void GameWorld::shootGun() {
+    if (ball.hasGun && ball.gunAmmo > 0) {
+        bullets.emplace_back(paddle.x + paddle.width / 2, paddle.y);
+        ball.gunAmmo--;
+        if (ball.gunAmmo == 0) {
+            ball.hasGun = false; // Deactivate Gun if ammo is depleted
+        }
+    }
+}
+
+void GameWorld::updateBullets() {
+    TRACE_ZONE("updateBullets");
+    for (auto& bullet : bullets) {
+        if (bullet.active) {
+            bullet.y += bullet.dy;
+            if (bullet.y < 0) {
+                bullet.active = false;
+            }
+        }
+    }
+    bullets.erase(std::remove_if(bullets.begin(), bullets.end(), [](const Bullet& b) { return !b.active; }), bullets.end());
+}
+
+void GameWorld::updatePaddle() {
+    if (paddle.controlsFlipped) {
+        if (paddle.moveLeft && paddle.x + paddle.width < SCREEN_WIDTH) {
+            paddle.x += PADDLE_SPEED;
+        }
+        if (paddle.moveRight && paddle.x > 0) {
+            paddle.x -= PADDLE_SPEED;
+        }
+    }
+    else {
+        if (paddle.moveLeft && paddle.x > 0) {
+            paddle.x -= PADDLE_SPEED;
+        }
+        if (paddle.moveRight && paddle.x + paddle.width < SCREEN_WIDTH) {
+            paddle.x += PADDLE_SPEED;
+        }
+    }
+}
+
+void GameWorld::updatePowerUps() {
+    TRACE_ZONE("updatePowerUps");
+    for (auto& powerUp : powerUps) {
+        if (powerUp.active) {
+            powerUp.x += powerUp.dx;
+            powerUp.y += powerUp.dy;
+            checkPowerUpCollision(powerUp);
+            // Check if power-up goes out of bounds
+            if (powerUp.y > SCREEN_HEIGHT) {
+                powerUp.active = false;
+            }
+        }
+    }
+}
+
+// Step
+
+namespace {
+
+// Charges the time since the previous lap to a phase; does nothing if times is null
+struct PhaseLap {
+    PhaseTimes *times;
+    std::chrono::steady_clock::time_point last;
+    PhaseLap(PhaseTimes *t) : times(t) { if (times) last = std::chrono::steady_clock::now(); }
+    void operator()(PhaseTimes::Phase phase) {
+        if (!times)
+            return;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        times->nanos[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+        times->laps[phase]++;
+        last = now;
+    }
+};
+
+} // end namespace
+
+void GameWorld::step(const GameInput &input) {
+    PhaseLap lap(phaseTimes);
+    tick++;
+    timers.advance(tick, [this](int event) { onTimer(event); });
+    if (state == AIM) {
+        aimAngle += 0.1f * input.aim;
+        if (aimAngle > maxAimAngle) aimAngle = maxAimAngle;
+        if (aimAngle < minAimAngle) aimAngle = minAimAngle;
+    }
+    if (input.space) {
+        if (state == AIM || (state == GAME && ball.idle)) {
+            ball.dx = ball.dx * cos(aimAngle);
+            ball.dy = ball.dy * sin(aimAngle);
+            ball.idle = false;
+            paddle.moveLeft = false;  // Reset paddle movements
+            paddle.moveRight = false; // Reset paddle movements
+            state = GAME;
+            return;
+        }
+        else if (state == GAME) {
+            shootGun();
+        }
+    }
+    if (state != GAME)
+        return;
+    paddle.moveLeft = input.moveLeft;
+    paddle.moveRight = input.moveRight;
+    lap(PhaseTimes::INPUT);
+    updatePaddle();
+    lap(PhaseTimes::PADDLE);
+    if (!ball.idle) {
+        updateBall();
+    }
+    lap(PhaseTimes::BALL);
+    updatePowerUps();
+    lap(PhaseTimes::POWER_UPS);
+    updateBullets();
+    lap(PhaseTimes::BULLETS);
+    if (field.liveCount() == 0) {
+        state = LEVEL_COMPLETE;
+    }
+}
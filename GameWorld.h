@@ -0,0 +1,167 @@
+// GameWorld.h - headless brick breaker simulation (no GL, GLFW or wall-clock dependency)
+
+#ifndef GAMEWORLD_HDR
+#define GAMEWORLD_HDR
+
+#include <stdint.h>
+#include <vector>
+#include "BrickBits.h"
+#include "BrickGrid.h"
+#include "Timers.h"
+
+const float PI = 3.1415926f;
+const int SCREEN_WIDTH = 800, SCREEN_HEIGHT = 600;
+const int BRICK_ROWS = 5, BRICK_COLS = 10;
+const int BRICK_WIDTH = 58, BRICK_HEIGHT = 20;
+const int BRICK_SPACING = 2;
+const int PADDLE_WIDTH = 100, PADDLE_HEIGHT = 20;
+const int BALL_RADIUS = 10;
+const int FIREBALL_DURATION = 5; // Duration of fireball state in seconds
+const float BALL_SPEED_L1 = 0.4f; // Ball speed for level 1
+const float BALL_SPEED_L2 = 0.5f; // Ball speed for level 2
+const float BALL_SPEED_L3 = 0.6f; // Ball speed for level 3
+const float PADDLE_SPEED = 0.4f; // Paddle Speed
+const float BULLET_SPEED = 0.5f; // Speed for bullets
+const int SHRINK_DURATION = 5; // Duration of the shrink state in seconds
+const float SHRINK_FACTOR = 0.5f; // Paddle Shrink
+const int SIM_HZ = 1000; // Fixed simulation rate; speeds above are in pixels per tick
+const float SIM_DT = 1.0f / SIM_HZ; // Seconds per tick
+const int MAX_BALL_CONTACTS = 4; // Brick contacts resolved per tick before the ball just moves on
+const float minAimAngle = PI / 6; // 30 degrees
+const float maxAimAngle = 5 * PI / 6; // 150 degrees
+
+enum GameState { MENU, AIM, GAME, GAME_OVER, WIN, LEVEL_SELECT, LEVEL_COMPLETE, EXIT, INSTRUCTIONS, POWER_UPS };
+
+enum PowerUpType { FIREBALL = 1, GUN, FLIP, SHRINK };
+
+struct Brick {
+    float x, y, width, height;
+    int type;
+    int hitsRemaining;
+    bool isVisible;
+    bool hasPowerUp;
+    PowerUpType powerUpType; // Type power-up
+    bool isBomb;
+    Brick(float x, float y, float w, float h, int t, bool powerUp = false, PowerUpType pType = FIREBALL, bool bomb = false)
+        : x(x), y(y), width(w), height(h), type(t), isVisible(true), hasPowerUp(powerUp), powerUpType(pType), isBomb(bomb) {
+        switch (type) {
+        case 1: hitsRemaining = 1; break; // 1hit
+        case 2: hitsRemaining = 2; break; // 2hit
+        case 3: hitsRemaining = 3; break; // 3hit
+        }
+    }
+};
+
+struct PowerUp {
+    float x, y; // Position power-up
+    float dx, dy; // Velocity power-up
+    bool active; // State power-up
+    float radius; // Radius power-up
+    PowerUpType type; // powerup type
+    PowerUp(float _x, float _y, float _dx, float _dy, PowerUpType _type) : x(_x), y(_y), dx(_dx), dy(_dy), active(true), radius(10.0f), type(_type) {}
+};
+
+struct Bullet {
+    float x, y, dy;
+    bool active;
+    Bullet(float _x, float _y) : x(_x), y(_y), dy(-BULLET_SPEED), active(true) {}
+};
+
+struct Ball {
+    float x, y, dx, dy, radius;
+    bool idle;
+    bool isFireball;
+    bool hasGun;
+    int gunAmmo;
+    Ball();
+    void normalizeVelocity();
+    void setSpeed(float speed);
+    void applyPowerUp(float multiplier);
+    void resetPowerUp();
+};
+
+struct Paddle {
+    float x, y, width, height;
+    bool moveLeft, moveRight, controlsFlipped, isShrunk;
+    Paddle() : x(SCREEN_WIDTH / 2 - PADDLE_WIDTH / 2), y(SCREEN_HEIGHT - 30), width(PADDLE_WIDTH), height(PADDLE_HEIGHT), moveLeft(false), moveRight(false), controlsFlipped(false), isShrunk(false) {}
+};
+
+// splitmix64; each world owns one, so a seed and the input log reproduce a session exactly
+struct Rng {
+    uint64_t state = 0;
+    uint32_t next();
+    int below(int n) { return (int) (next() % (uint32_t) n); } // in [0, n)
+    void shuffle(std::vector<int> &v);
+};
+
+// Player input for one tick; held keys are levels, the rest are edges
+struct GameInput {
+    bool moveLeft = false, moveRight = false; // paddle keys held
+    int aim = 0; // aim nudges this step (+1 per left press, -1 per right press)
+    bool space = false; // SPACE pressed this step: launch the ball or fire the gun
+};
+
+// Time spent in each part of GameWorld::step, for benchmarks
+struct PhaseTimes {
+    enum Phase { INPUT, PADDLE, BALL, POWER_UPS, BULLETS, NPHASES }; // INPUT includes due timers
+    long long nanos[NPHASES] = {};
+    long long laps[NPHASES] = {}; // times each phase was charged; each lap includes one clock read
+};
+
+// All state for one game; independent instances may be stepped side by side
+class GameWorld {
+public:
+    std::vector<Brick> bricks;
+    int brickLayout = 0; // bumped whenever setupBricks rebuilds bricks
+    std::vector<int> changedBricks; // bricks hit or destroyed since the last rebuild or since the client cleared this
+    std::vector<PowerUp> powerUps; // To store power-ups
+    std::vector<Bullet> bullets; // To store bullets
+    Ball ball;
+    Paddle paddle;
+    GameState state = AIM; // AIM, GAME, GAME_OVER or LEVEL_COMPLETE
+    int score = 0;
+    int lives = 1;
+    int level = 1;
+    int rows = BRICK_ROWS, cols = BRICK_COLS; // brick field dimensions
+    int bricksBroken = 0; // Track the number of bricks broken
+    int breaks = 0, blasts = 0; // bricks destroyed and bombs set off since the client zeroed these (for sound)
+    bool resetAfterLifeLost = false; // Flag to reset the ball after losing a life
+    float aimAngle = PI / 6;
+    long long tick = 0; // ticks simulated so far (SIM_HZ per second); the world's only clock
+    Rng rng; // drives brick layout; seed before reset for a reproducible game
+    PhaseTimes *phaseTimes = nullptr; // if set, step adds each phase's elapsed time here
+    void seed(uint64_t s) { rng.state = s; }
+    void reset(int level, int rows = BRICK_ROWS, int cols = BRICK_COLS);
+        // start a new game at level on a rows x cols field, score and lives cleared
+    void nextLevel();
+        // advance level and rebuild the field, keeping score and lives
+    void step(const GameInput &input);
+        // advance by one fixed tick of SIM_DT seconds
+private:
+    BrickGrid grid; // broadphase over bricks, rebuilt by setupBricks
+    BrickBits field; // visibility and bombs as bitmasks; Brick::isVisible mirrors it for drawing
+    std::vector<int> candidates; // scratch for grid queries
+    std::vector<int> cleared; // scratch for bomb blasts
+    std::vector<int> lowestRow; // per column, the lowest row with a live brick (-1 if none)
+    enum TimerEvent { FIREBALL_EXPIRED, SHRINK_EXPIRED };
+    TimerQueue timers; // power-up expirations, due in ticks
+    int fireballTimer = 0; // pending handle, 0 if none
+    void onTimer(int event);
+    void setupBricks();
+    void startLevel();
+    void killBrick(int index);
+    void liftColumn(int index);
+    int bulletTarget(const Bullet &bullet);
+    void destroySurroundingBricks(int bombIndex);
+    void hitBrick(int index, float nx, float ny);
+    void sweepBall();
+    void checkCollisions();
+    bool checkPowerUpCollision(PowerUp &powerUp);
+    void updateBall();
+    void shootGun();
+    void updateBullets();
+    void updatePaddle();
+    void updatePowerUps();
+};
+
+#endif
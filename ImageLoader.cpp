@@ -0,0 +1,56 @@
+// ImageLoader.cpp - decode image files on worker threads, for upload on the GL thread
+
+#include "ImageLoader.h"
+#include "stb_image.h"
+#include <stdio.h>
+#include <algorithm>
+
+bool DecodeImage(const char *filename, Image &image) {
+    int w, h, channels;
+    unsigned char *data = stbi_load(filename, &w, &h, &channels, 4);
+    if (!data) {
+        fprintf(stderr, "Failed to load %s\n", filename);
+        image = Image();
+        return false;
+    }
+    image.width = w;
+    image.height = h;
+    image.pixels.assign(data, data + w * h * 4);
+    stbi_image_free(data);
+    return true;
+}
+
+void ImageLoader::start(const char *const fileList[], int nFiles, int nThreads) {
+    wait();
+    files.assign(fileList, fileList + nFiles);
+    images.assign(nFiles, Image());
+    next = 0;
+    finished = 0;
+    if (nThreads <= 0)
+        nThreads = std::max(1, (int) std::thread::hardware_concurrency());
+    nThreads = std::min(nThreads, nFiles);
+    for (int i = 0; i < nThreads; i++)
+        workers.emplace_back(&ImageLoader::work, this);
+}
+
+void ImageLoader::work() {
+    // each image is written by one worker only, and published by the release on finished
+    for (int i; (i = next.fetch_add(1)) < (int) files.size(); ) {
+        DecodeImage(files[i].c_str(), images[i]);
+        finished.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void ImageLoader::wait() {
+    for (std::thread &t : workers)
+        t.join();
+    workers.clear();
+}
+
+void ImageLoader::clear() {
+    wait();
+    files.clear();
+    images.clear();
+    next = 0;
+    finished = 0;
+}
@@ -0,0 +1,46 @@
+// ImageLoader.h - decode image files on worker threads, for upload on the GL thread
+
+#ifndef IMAGELOADER_HDR
+#define IMAGELOADER_HDR
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+// PNG/JPG decoding is the slow part of loading a sprite, and needs no GL
+// context, so start hands the files to a few worker threads and returns at
+// once. The main thread keeps rendering (the menu needs no images), polls done
+// each frame, and uploads the decoded pixels when they are all in. Workers
+// take the next file from a shared counter, so the wall time is about the
+// slowest decode times files / threads.
+
+struct Image {
+    int width = 0, height = 0;
+    std::vector<unsigned char> pixels; // RGBA, top row first; empty if the file couldn't be decoded
+};
+
+bool DecodeImage(const char *filename, Image &image);
+    // decode synchronously to RGBA; on failure print a message and leave image empty
+
+class ImageLoader {
+public:
+    ~ImageLoader() { wait(); }
+    void start(const char *const files[], int nFiles, int nThreads = 0);
+        // begin decoding; nThreads 0 means one per core, never more than nFiles
+    bool done() const { return finished.load(std::memory_order_acquire) == (int) images.size(); }
+    void wait();
+        // block until every file is decoded and the workers have exited
+    const Image &image(int i) const { return images[i]; } // valid once done
+    const Image *data() const { return images.data(); }
+    void clear();
+        // wait, then free the decoded pixels (once they are uploaded)
+private:
+    std::vector<std::string> files;
+    std::vector<Image> images;
+    std::vector<std::thread> workers;
+    std::atomic<int> next{0}, finished{0};
+    void work();
+};
+
+#endif
@@ -0,0 +1,59 @@
+// GLState.h - shadowed OpenGL binding and enable state
+// Copyright (c) 2024 Jules Bloomenthal, all rights reserved. Commercial use requires license.
+
+#ifndef GL_STATE_HDR
+#define GL_STATE_HDR
+
+// Lib modules and the application bind through these instead of glUseProgram,
+// glBindVertexArray, glBindBuffer, glActiveTexture, glBindTexture, glEnable and
+// glDisable. Each call is compared with a CPU-side shadow of the current context
+// and reaches the driver only if it changes something; nothing is read back
+// from the driver. The shadow assumes one context and one thread. Names and
+// enums are unsigned int, so this needs no GL header and suits code built
+// against either glad or the system's gl.h.
+
+// The shadow starts at a new context's defaults: nothing bound, texture unit 0,
+// only GL_DITHER and GL_MULTISAMPLE enabled. Texturing enables (GL_TEXTURE_2D
+// and the like) are kept per texture unit, as fixed-function GL keeps them.
+// Code that binds or enables with gl* directly must call ResetGLState
+// afterwards; until each is set again, queries report 0 or false and the next
+// call of each kind is issued.
+
+void UseProgram(unsigned int program);
+void BindVertexArray(unsigned int vao);
+	// the element array binding belongs to the vertex array, so it is forgotten on change
+void BindBuffer(unsigned int target, unsigned int buffer);
+void BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+	// always issued (indexed bindings are not shadowed); also sets target's generic binding
+void ActiveTexture(unsigned int unit);
+	// unit is GL_TEXTURE0+n
+void BindTexture(unsigned int target, unsigned int texture);
+	// bind to the active unit
+void Enable(unsigned int cap);
+void Disable(unsigned int cap);
+
+unsigned int BoundProgram();
+unsigned int BoundVertexArray();
+unsigned int BoundBuffer(unsigned int target);
+unsigned int BoundTexture(unsigned int target);
+	// on the active unit
+bool IsEnabled(unsigned int cap);
+
+// deletion unbinds names from the context; these keep the shadow in step
+void DeleteBuffers(int n, const unsigned int *buffers);
+void DeleteTextures(int n, const unsigned int *textures);
+void DeleteVertexArrays(int n, const unsigned int *vaos);
+void ForgetProgram(unsigned int program);
+	// call before glDeleteProgram: a deleted program stays current until replaced
+
+void ResetGLState();
+
+struct GLStateCounts {
+	int issued = 0; // binds and enables sent to the driver
+	int elided = 0; // redundant ones skipped
+};
+
+GLStateCounts GetGLStateCounts();
+void ClearGLStateCounts();
+
+#endif
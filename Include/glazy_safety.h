@@ -0,0 +1,40 @@
+#pragma once
+
+// Entry and exit guards around glazy's GL calls.
+//
+// In release builds (NDEBUG, unless GLAZY_DIAGNOSTICS is set to 1) the guard
+// macros expand to nothing: no strings, no calls, no glGetError round trips.
+//
+// In diagnostic builds the guards take the function name as a string literal.
+// With KHR_debug (GL 4.3, or the extension on 4.1+) context::setup asks for a
+// debug context and installs a glDebugMessageCallback; the driver then reports
+// errors asynchronously, and a guard only reads one atomic flag and throws the
+// first reported message, tagged with the last guarded function. Without
+// KHR_debug the guards fall back to polling glGetError as before.
+
+#ifndef GLAZY_DIAGNOSTICS
+#ifdef NDEBUG
+#define GLAZY_DIAGNOSTICS 0
+#else
+#define GLAZY_DIAGNOSTICS 1
+#endif
+#endif
+
+namespace glazy {
+	namespace safety {
+		void entry_guard(const char* fn_name);
+		void exit_guard(const char* fn_name);
+
+		// Install the debug message callback on the current context; false if
+		// KHR_debug is unavailable or this is not a diagnostic build.
+		bool enable_debug_output();
+	}
+}
+
+#if GLAZY_DIAGNOSTICS
+#define GLAZY_ENTRY_GUARD(fn_name) ::glazy::safety::entry_guard(fn_name)
+#define GLAZY_EXIT_GUARD(fn_name) ::glazy::safety::exit_guard(fn_name)
+#else
+#define GLAZY_ENTRY_GUARD(fn_name) ((void) 0)
+#define GLAZY_EXIT_GUARD(fn_name) ((void) 0)
+#endif
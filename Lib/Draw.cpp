@@ -3,6 +3,7 @@
 
 #include <glad.h>
 #include "Draw.h"
+#include "GLState.h"
 #include "GLXtras.h"
 #include "Text.h"
 #include <float.h>
@@ -82,7 +83,7 @@ bool IsVisible(vec3 p, mat4 fullview, vec2 *screenA, int *w, int *h, float fudge
 }
 
 bool DepthXY(int x, int y, float &depth) {
-	if (glIsEnabled(GL_DEPTH_TEST)) {
+	if (IsEnabled(GL_DEPTH_TEST)) {
 		float v, depthRange[2]; // depthRange maps to window coordinates +/-1
 		glGetFloatv(GL_DEPTH_RANGE, depthRange);
 		glReadPixels(x, y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &v);
@@ -339,11 +340,10 @@ mat4 GetDrawView() { return drawView; }
 void SetDrawView(mat4 m) { drawView = m; }
 
 GLuint UseDrawShader() {
-	int was = 0;
-	glGetIntegerv(GL_CURRENT_PROGRAM, &was);
+	GLuint was = BoundProgram();
 	bool init = !drawShader;
 	if (init) drawShader = LinkProgramViaCode(&drawVShader, &drawPShader);
-	glUseProgram(drawShader);
+	UseProgram(drawShader);
 	if (init) drawView = mat4();
 	SetUniform(drawShader, "view", drawView);
 	return was;
@@ -371,12 +371,12 @@ void Disk(vec3 p, float diameter, vec3 color, float opacity, bool ring) {
 	if (!diskVBO) {
 		glGenVertexArrays(1, &diskVAO);
 		glGenBuffers(1, &diskVBO);
-		glBindVertexArray(diskVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, diskVBO);
+		BindVertexArray(diskVAO);
+		BindBuffer(GL_ARRAY_BUFFER, diskVBO);
 		glBufferData(GL_ARRAY_BUFFER, 2*sizeof(vec3), NULL, GL_STATIC_DRAW);
 	}
-	glBindVertexArray(diskVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, diskVBO); // set active buffer
+	BindVertexArray(diskVAO);
+	BindBuffer(GL_ARRAY_BUFFER, diskVBO); // set active buffer
 	// allocate buffer memory and load location and color data
 	glBufferSubData(GL_ARRAY_BUFFER, 0, 3*sizeof(float), &p.x);
 	glBufferSubData(GL_ARRAY_BUFFER, 3*sizeof(float), 3*sizeof(float), &color.x);
@@ -384,23 +384,23 @@ void Disk(vec3 p, float diameter, vec3 color, float opacity, bool ring) {
 	VertexAttribPointer(drawShader, "position", 3, 0, (void *) 0);
 	VertexAttribPointer(drawShader, "color", 3, 0, (void *) sizeof(vec3));
 	// draw
-	glEnable(GL_BLEND);
+	Enable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	SetUniform(drawShader, "opacity", opacity);
 	SetUniform(drawShader, "ring", ring);
 	glPointSize(diameter);
 #ifdef GL_POINT_SMOOTH
-	glEnable(GL_POINT_SMOOTH);
+	Enable(GL_POINT_SMOOTH);
 #endif
 #if !defined(GL_POINT_SMOOTH) && defined(GL_POINT_SPRITE)
-	glEnable(GL_POINT_SPRITE);
+	Enable(GL_POINT_SPRITE);
 #endif
 #if !defined(GL_POINT_SMOOTH) && !defined(GL_POINT_SPRITE)
-	glEnable(0x8861); // same as GL_POINT_SMOOTH [this is a 4.5 core bug]
+	Enable(0x8861); // same as GL_POINT_SMOOTH [this is a 4.5 core bug]
 	SetUniform(drawShader, "fadeToCenter", true); // needed if GL_POINT_SMOOTH and GL_POINT_SPRITE fail
 #endif
 	glDrawArrays(GL_POINTS, 0, 1);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 // Lines
@@ -414,13 +414,13 @@ void Line(vec3 p1, vec3 p2, float width, vec3 col1, vec3 col2, float opacity) {
 	if (!lineVBO) {
 		glGenVertexArrays(1, &lineVAO);
 		glGenBuffers(1, &lineVBO);
-		glBindVertexArray(lineVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
+		BindVertexArray(lineVAO);
+		BindBuffer(GL_ARRAY_BUFFER, lineVBO);
 		glBufferData(GL_ARRAY_BUFFER, sizeof(data), NULL, GL_STATIC_DRAW);
 	}
 	// set active vertex buffer, load location and color data
-	glBindVertexArray(lineVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
+	BindVertexArray(lineVAO);
+	BindBuffer(GL_ARRAY_BUFFER, lineVBO);
 	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(data), (void *) data);
 	// connect shader inputs, set uniforms
 	VertexAttribPointer(drawShader, "position", 3, 0, (void *) 0);
@@ -431,7 +431,7 @@ void Line(vec3 p1, vec3 p2, float width, vec3 col1, vec3 col2, float opacity) {
 	glLineWidth(width);
 	glDrawArrays(GL_LINES, 0, 2);
 	// cleanup
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void Line(vec3 p1, vec3 p2, float width, vec3 col, float opacity) {
@@ -474,18 +474,21 @@ void LineDot(vec3 p1, vec3 p2, mat4 view, float width, vec3 col, float opacity,
 }
 
 GLuint lineStripVBO = 0, lineStripVAO = 0;
+int lineStripCapacity = 0; // bytes
 
 void LineStrip(int nPoints, vec3 *points, vec3 &color, float opacity, float width) {
 	int pSize = nPoints*sizeof(vec3);
 	if (!lineStripVBO) {
 		glGenVertexArrays(1, &lineStripVAO);
 		glGenBuffers(1, &lineStripVBO);
-		glBindVertexArray(lineStripVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, lineStripVBO);
-		glBufferData(GL_ARRAY_BUFFER, 2*pSize, NULL, GL_STATIC_DRAW);
 	}
-	glBindVertexArray(lineStripVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, lineStripVBO);
+	BindVertexArray(lineStripVAO);
+	BindBuffer(GL_ARRAY_BUFFER, lineStripVBO);
+	if (2*pSize > lineStripCapacity) {
+		// grow to fit positions then colors
+		lineStripCapacity = 2*pSize;
+		glBufferData(GL_ARRAY_BUFFER, lineStripCapacity, NULL, GL_DYNAMIC_DRAW);
+	}
 	std::vector<vec3> colors(nPoints, color);
 	glBufferSubData(GL_ARRAY_BUFFER, 0, pSize, points);
 	glBufferSubData(GL_ARRAY_BUFFER, pSize, pSize, colors.data());
@@ -513,12 +516,12 @@ void QuadInner(vec3 p1, vec3 p2, vec3 p3, vec3 p4, bool solid, vec3 col, float o
 	if (quadVBO == 0) {
 		glGenVertexArrays(1, &quadVAO);
 		glGenBuffers(1, &quadVBO);
-		glBindVertexArray(quadVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+		BindVertexArray(quadVAO);
+		BindBuffer(GL_ARRAY_BUFFER, quadVBO);
 		glBufferData(GL_ARRAY_BUFFER, sizeof(data), NULL, GL_STATIC_DRAW);
 	}
-	glBindVertexArray(quadVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	BindVertexArray(quadVAO);
+	BindBuffer(GL_ARRAY_BUFFER, quadVBO);
 	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(data), data);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
 	VertexAttribPointer(drawShader, "position", 3, 0, (void *) 0);
@@ -527,8 +530,8 @@ void QuadInner(vec3 p1, vec3 p2, vec3 p3, vec3 p4, bool solid, vec3 col, float o
 	SetUniform(drawShader, "fadeToCenter", false);
 	SetUniform(drawShader, "useTexture", texture);
 	if (texture) {
-		glActiveTexture(GL_TEXTURE0+textureUnit);
-		glBindTexture(GL_TEXTURE_2D, textureName);
+		ActiveTexture(GL_TEXTURE0+textureUnit);
+		BindTexture(GL_TEXTURE_2D, textureName);
 		SetUniform(drawShader, "textureImage", textureUnit);
 		SetUniform(drawShader, "nTexChannels", nTexChannels);
 	}
@@ -707,7 +710,7 @@ void Cylinder(vec3 p1, vec3 p2, float r1, float r2, mat4 modelview, mat4 persp,
 	if (!cylinderShader)
 		cylinderShader = LinkProgramViaCode(&cylVShader, &cylTCShader, &cylTEShader, NULL, &cylPShader);
 	//	cylinderShader = LinkProgramViaCode(&vShader, NULL, &teShader, NULL, &pShader);
-	glUseProgram(cylinderShader);
+	UseProgram(cylinderShader);
 	SetUniform(cylinderShader, "modelview", modelview);
 	SetUniform(cylinderShader, "persp", persp);
 	SetUniform(cylinderShader, "color", color);
@@ -820,12 +823,12 @@ GLuint UseTriangleShader() {
 	bool init = triShader == 0;
 	if (init)
 		triShader = LinkProgramViaCode(&triVShaderCode, NULL, NULL, &triGShaderCode, &triPShaderCode);
-	glUseProgram(triShader);
+	UseProgram(triShader);
 	if (init)
 		SetUniform(triShader, "view", mat4());
-	glEnable(GL_BLEND);
+	Enable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_LINE_SMOOTH);
+	Enable(GL_LINE_SMOOTH);
 	return triShader;
 }
 
@@ -842,12 +845,12 @@ void Triangle(vec3 p1, vec3 p2, vec3 p3, vec3 c1, vec3 c2, vec3 c3,
 	if (triVBO == 0) {
 		glGenVertexArrays(1, &triVAO);
 		glGenBuffers(1, &triVBO);
-		glBindVertexArray(triVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, triVBO);
+		BindVertexArray(triVAO);
+		BindBuffer(GL_ARRAY_BUFFER, triVBO);
 		glBufferData(GL_ARRAY_BUFFER, 3*sizeof(vec3), NULL, GL_STATIC_DRAW);
 	}
-	glBindVertexArray(triVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, triVBO);
+	BindVertexArray(triVAO);
+	BindBuffer(GL_ARRAY_BUFFER, triVBO);
 	glBufferSubData(GL_ARRAY_BUFFER, 0, 3*sizeof(vec3), data);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
 	VertexAttribPointer(triShader, "point", 3, 0, (void *) 0);
@@ -0,0 +1,219 @@
+// GLState.cpp - shadowed OpenGL binding and enable state
+// Copyright (c) 2024 Jules Bloomenthal, all rights reserved. Commercial use requires license.
+
+#include <glad.h>
+#include "GLState.h"
+#include <stddef.h>
+#include <vector>
+
+namespace {
+
+const GLuint UNKNOWN = 0xffffffff;
+const int NUNITS = 32;
+
+// shadowed targets; a bind to any other target is always issued
+const GLenum bufferTargets[] = {
+	GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER,
+	GL_ATOMIC_COUNTER_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+	GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER };
+const GLenum textureTargets[] = {
+	GL_TEXTURE_2D, GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BUFFER };
+const int NBUFFERTARGETS = sizeof(bufferTargets)/sizeof(GLenum);
+const int NTEXTURETARGETS = sizeof(textureTargets)/sizeof(GLenum);
+
+struct Cap { GLenum cap; GLuint unit; bool on; }; // unit is 0 unless the cap is per texture unit
+
+GLuint program = 0, vao = 0, unit = 0; // unit is an index, not GL_TEXTURE0+n
+GLuint buffers[NBUFFERTARGETS] = {};
+GLuint textures[NUNITS][NTEXTURETARGETS] = {};
+std::vector<Cap> caps; // every cap set since the last reset
+bool capDefaults = true; // caps not listed are at their defaults, else unknown
+
+GLStateCounts counts;
+
+int Find(const GLenum *targets, int n, GLenum target) {
+	for (int i = 0; i < n; i++)
+		if (targets[i] == target)
+			return i;
+	return -1;
+}
+
+bool Change(GLuint &shadow, GLuint name) {
+	// record name, return true if the driver must be told
+	if (shadow == name) {
+		counts.elided++;
+		return false;
+	}
+	shadow = name;
+	counts.issued++;
+	return true;
+}
+
+GLuint Known(GLuint name) { return name == UNKNOWN? 0 : name; }
+
+GLuint *TextureShadow(GLenum target) {
+	int t = Find(textureTargets, NTEXTURETARGETS, target);
+	return t < 0 || unit >= NUNITS? NULL : &textures[unit][t];
+}
+
+bool DefaultCap(GLenum cap) { return cap == GL_DITHER || cap == GL_MULTISAMPLE; }
+
+bool PerUnitCap(GLenum cap) {
+	// fixed-function texturing is enabled separately on each texture unit
+	return cap == GL_TEXTURE_1D || cap == GL_TEXTURE_2D || cap == GL_TEXTURE_3D || cap == GL_TEXTURE_CUBE_MAP;
+}
+
+Cap *FindCap(GLenum cap, GLuint u) {
+	for (Cap &c : caps)
+		if (c.cap == cap && c.unit == u)
+			return &c;
+	return NULL;
+}
+
+void SetCap(GLenum cap, bool on) {
+	bool perUnit = PerUnitCap(cap);
+	if (perUnit && unit == UNKNOWN) { // can't tell which unit this applies to
+		counts.issued++;
+		if (on) glEnable(cap); else glDisable(cap);
+		return;
+	}
+	GLuint u = perUnit? unit : 0;
+	Cap *c = FindCap(cap, u);
+	if (c? c->on == on : capDefaults && DefaultCap(cap) == on) {
+		counts.elided++;
+		return;
+	}
+	if (c)
+		c->on = on;
+	else
+		caps.push_back({cap, u, on});
+	counts.issued++;
+	if (on) glEnable(cap); else glDisable(cap);
+}
+
+} // end namespace
+
+// Binding
+
+void UseProgram(GLuint p) {
+	if (Change(program, p))
+		glUseProgram(p);
+}
+
+void BindVertexArray(GLuint v) {
+	if (Change(vao, v)) {
+		glBindVertexArray(v);
+		buffers[Find(bufferTargets, NBUFFERTARGETS, GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+	}
+}
+
+void BindBuffer(GLenum target, GLuint buffer) {
+	int t = Find(bufferTargets, NBUFFERTARGETS, target);
+	if (t < 0) {
+		counts.issued++;
+		glBindBuffer(target, buffer);
+	}
+	else if (Change(buffers[t], buffer))
+		glBindBuffer(target, buffer);
+}
+
+void BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+	int t = Find(bufferTargets, NBUFFERTARGETS, target);
+	if (t >= 0)
+		buffers[t] = buffer;
+	counts.issued++;
+	glBindBufferBase(target, index, buffer);
+}
+
+void ActiveTexture(GLenum u) {
+	if (Change(unit, u-GL_TEXTURE0))
+		glActiveTexture(u);
+}
+
+void BindTexture(GLenum target, GLuint texture) {
+	GLuint *shadow = TextureShadow(target);
+	if (!shadow) {
+		counts.issued++;
+		glBindTexture(target, texture);
+	}
+	else if (Change(*shadow, texture))
+		glBindTexture(target, texture);
+}
+
+void Enable(GLenum cap) { SetCap(cap, true); }
+
+void Disable(GLenum cap) { SetCap(cap, false); }
+
+// Queries
+
+GLuint BoundProgram() { return Known(program); }
+
+GLuint BoundVertexArray() { return Known(vao); }
+
+GLuint BoundBuffer(GLenum target) {
+	int t = Find(bufferTargets, NBUFFERTARGETS, target);
+	return t < 0? 0 : Known(buffers[t]);
+}
+
+GLuint BoundTexture(GLenum target) {
+	GLuint *shadow = TextureShadow(target);
+	return shadow? Known(*shadow) : 0;
+}
+
+bool IsEnabled(GLenum cap) {
+	bool perUnit = PerUnitCap(cap);
+	if (perUnit && unit == UNKNOWN)
+		return false;
+	Cap *c = FindCap(cap, perUnit? unit : 0);
+	return c? c->on : capDefaults && DefaultCap(cap);
+}
+
+// Deletion
+
+void DeleteBuffers(int n, const GLuint *names) {
+	for (int i = 0; i < n; i++)
+		for (GLuint &b : buffers)
+			if (b == names[i])
+				b = 0;
+	glDeleteBuffers(n, names);
+}
+
+void DeleteTextures(int n, const GLuint *names) {
+	for (int i = 0; i < n; i++)
+		for (auto &u : textures)
+			for (GLuint &t : u)
+				if (t == names[i])
+					t = 0;
+	glDeleteTextures(n, names);
+}
+
+void DeleteVertexArrays(int n, const GLuint *names) {
+	for (int i = 0; i < n; i++)
+		if (vao == names[i]) {
+			vao = 0;
+			buffers[Find(bufferTargets, NBUFFERTARGETS, GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+		}
+	glDeleteVertexArrays(n, names);
+}
+
+void ForgetProgram(GLuint p) {
+	if (program == p)
+		program = UNKNOWN;
+}
+
+void ResetGLState() {
+	program = vao = unit = UNKNOWN;
+	for (GLuint &b : buffers)
+		b = UNKNOWN;
+	for (auto &u : textures)
+		for (GLuint &t : u)
+			t = UNKNOWN;
+	caps.clear();
+	capDefaults = false;
+}
+
+// Counts
+
+GLStateCounts GetGLStateCounts() { return counts; }
+
+void ClearGLStateCounts() { counts = GLStateCounts(); }
@@ -2,9 +2,11 @@
 // Copyright (c) 2024 Jules Bloomenthal, all rights reserved. Commercial use requires license.
 
 #include <glad.h>
+#include "GLState.h"
 #include "GLXtras.h"
 #include <stdio.h>
 #include <string.h>
+#include <string>
 #include <time.h>
 #include <vector>
 #include <unordered_map>
@@ -265,6 +267,89 @@ void PrintProgramUniforms(int programID) {
 	}
 }
 
+// Uniform Locations
+
+// each program's uniform locations are found once, when it is linked (or on
+// first use, if linked elsewhere), and then looked up by a hash of the name
+
+namespace {
+
+struct NamedLocation {
+	unsigned int hash;
+	GLint id;
+	std::string name;
+};
+
+typedef std::vector<NamedLocation> UniformLocations;
+
+std::unordered_map<int, UniformLocations> uniformLocations;
+int lastProgram = 0;
+UniformLocations *lastLocations = NULL; // map nodes are stable, so this survives rehashing
+
+unsigned int HashName(const char *name) {
+	unsigned int h = 2166136261u; // FNV-1a
+	for (const char *c = name; *c; c++)
+		h = (h^(unsigned char) *c)*16777619u;
+	return h;
+}
+
+void AddLocation(UniformLocations &locations, const char *name, GLint id) {
+	locations.push_back({HashName(name), id, name});
+}
+
+void ResolveUniforms(int program) {
+	UniformLocations &locations = uniformLocations[program];
+	locations.clear();
+	GLint nUniforms = 0;
+	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &nUniforms);
+	for (int i = 0; i < nUniforms; i++) {
+		GLenum type;
+		GLchar name[201];
+		GLint length, size;
+		glGetActiveUniform(program, i, 200, &length, &size, &type, name);
+		GLint id = glGetUniformLocation(program, name);
+		if (id < 0)
+			continue; // member of a uniform block
+		AddLocation(locations, name, id);
+		if (length > 3 && !strcmp(name+length-3, "[0]")) {
+			name[length-3] = 0; // arrays are also set by their bare name
+			AddLocation(locations, name, id);
+		}
+	}
+	lastProgram = program;
+	lastLocations = &locations;
+}
+
+void ForgetUniforms(int program) {
+	uniformLocations.erase(program);
+	if (lastProgram == program)
+		lastLocations = NULL;
+}
+
+GLint UniformLocation(int program, const char *name) {
+	if (!program)
+		return -1;
+	if (program != lastProgram || !lastLocations) {
+		auto it = uniformLocations.find(program);
+		if (it == uniformLocations.end())
+			ResolveUniforms(program);
+		else {
+			lastProgram = program;
+			lastLocations = &it->second;
+		}
+	}
+	unsigned int hash = HashName(name);
+	for (NamedLocation &u : *lastLocations)
+		if (u.hash == hash && u.name == name)
+			return u.id;
+	// not an active uniform's name (perhaps an array element or struct member): ask once
+	GLint id = glGetUniformLocation(program, name);
+	AddLocation(*lastLocations, name, id);
+	return id;
+}
+
+} // end namespace
+
 // Compilation
 
 GLuint CompileShaderViaFile(const char *filename, GLint type) {
@@ -359,6 +444,7 @@ void LinkProgramViaCode(GLuint computeProgram, const char **computeCode) {
 	GLint status;
 	glGetProgramiv(computeProgram, GL_LINK_STATUS, &status);
 	if (status == GL_FALSE) PrintProgramLog(computeProgram);
+	ResolveUniforms(computeProgram);
 }
 
 GLuint LinkProgramViaCode(const char **computeCode) {
@@ -377,6 +463,7 @@ GLuint LinkProgramViaFile(const char *computeShaderFile) {
 	GLint status;
 	glGetProgramiv(program, GL_LINK_STATUS, &status);
 	if (status == GL_FALSE) PrintProgramLog(program);
+	ResolveUniforms(program);
 	return program;
 }
 
@@ -407,6 +494,7 @@ bool ReadProgramBinary(GLuint program, const char *filename) {
 		fread((char *) &data[0], 1, sizeBinary, in);
 		fclose(in);
 		glProgramBinary(program, binaryFormat, &data[0], sizeBinary);
+		ResolveUniforms(program);
 		return true;
 	}
 	return false;
@@ -443,6 +531,7 @@ GLuint LinkProgram(GLuint vshader, GLuint tcshader, GLuint teshader, GLuint gsha
 		GLint status;
 		glGetProgramiv(program, GL_LINK_STATUS, &status);
 		if (status == GL_FALSE) PrintProgramLog(program);
+		ResolveUniforms(program);
 	}
 	return program;
 }
@@ -456,9 +545,7 @@ GLuint LinkProgramViaFile(const char *vertexShaderFile, const char *pixelShaderF
 // Miscellany
 
 int CurrentProgram() {
-	int program = 0;
-	glGetIntegerv(GL_CURRENT_PROGRAM, &program);
-	return program;
+	return (int) BoundProgram();
 }
 
 void DeleteProgram(int program) {
@@ -468,6 +555,8 @@ void DeleteProgram(int program) {
 	glGetAttachedShaders(program, nShaders, NULL, shaderNames);
 	for (int i = 0; i < nShaders; i++)
 		glDeleteShader(shaderNames[i]);
+	ForgetProgram(program);
+	ForgetUniforms(program);
 	glDeleteProgram(program);
 }
 
@@ -486,7 +575,7 @@ bool Bad(const char *name) {
 }
 
 bool SetUniform(int program, const char *name, bool val) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform1ui(id, val? 1 : 0);
@@ -494,7 +583,7 @@ bool SetUniform(int program, const char *name, bool val) {
 }
 
 bool SetUniform(int program, const char *name, int val) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform1i(id, val);
@@ -503,7 +592,7 @@ bool SetUniform(int program, const char *name, int val) {
 
 // following might confuse some compilers
 bool SetUniform(int program, const char *name, GLuint val) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform1ui(id, val);
@@ -511,7 +600,7 @@ bool SetUniform(int program, const char *name, GLuint val) {
 }
 
 bool SetUniformv(int program, const char *name, int count, int *v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform1iv(id, count, v);
@@ -519,7 +608,7 @@ bool SetUniformv(int program, const char *name, int count, int *v) {
 }
 
 bool SetUniform(int program, const char *name, float val) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform1f(id, val);
@@ -527,7 +616,7 @@ bool SetUniform(int program, const char *name, float val) {
 }
 
 bool SetUniformv(int program, const char *name, int count, float *v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform1fv(id, count, v);
@@ -535,7 +624,7 @@ bool SetUniformv(int program, const char *name, int count, float *v) {
 }
 
 bool SetUniform(int program, const char *name, vec2 v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform2f(id, v.x, v.y);
@@ -543,7 +632,7 @@ bool SetUniform(int program, const char *name, vec2 v) {
 }
 
 bool SetUniform(int program, const char *name, vec3 v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform3f(id, v.x, v.y, v.z);
@@ -551,7 +640,7 @@ bool SetUniform(int program, const char *name, vec3 v) {
 }
 
 bool SetUniform(int program, const char *name, vec4 v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform4f(id, v.x, v.y, v.z, v.w);
@@ -559,7 +648,7 @@ bool SetUniform(int program, const char *name, vec4 v) {
 }
 
 bool SetUniform(int program, const char *name, vec3 *v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform3fv(id, 1, (float *) v);
@@ -567,7 +656,7 @@ bool SetUniform(int program, const char *name, vec3 *v) {
 }
 
 bool SetUniform(int program, const char *name, vec4 *v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform4fv(id, 1, (float *) v);
@@ -575,7 +664,7 @@ bool SetUniform(int program, const char *name, vec4 *v) {
 }
 
 bool SetUniform3(int program, const char *name, float *v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform3fv(id, 1, v);
@@ -583,7 +672,7 @@ bool SetUniform3(int program, const char *name, float *v) {
 }
 
 bool SetUniform2v(int program, const char *name, int count, float *v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform2fv(id, count, v);
@@ -591,7 +680,7 @@ bool SetUniform2v(int program, const char *name, int count, float *v) {
 }
 
 bool SetUniform3v(int program, const char *name, int count, float *v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform3fv(id, count, v);
@@ -599,7 +688,7 @@ bool SetUniform3v(int program, const char *name, int count, float *v) {
 }
 
 bool SetUniform4v(int program, const char *name, int count, float *v) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniform4fv(id, count, v);
@@ -615,7 +704,7 @@ bool SetUniform3v(int program, const char *name, int count, float *v, mat4 m) {
 }
 
 bool SetUniform(int program, const char *name, mat3 m) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniformMatrix3fv(id, 1, true, (float *) &m[0][0]);
@@ -623,7 +712,7 @@ bool SetUniform(int program, const char *name, mat3 m) {
 }
 
 bool SetUniform(int program, const char *name, mat4 m) {
-	GLint id = glGetUniformLocation(program, name);
+	GLint id = UniformLocation(program, name);
 	if (id < 0)
 		return Bad(name);
 	glUniformMatrix4fv(id, 1, true, (float *) &m[0][0]);
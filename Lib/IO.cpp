@@ -2,6 +2,7 @@
 // Copyright (c) 2024 Jules Bloomenthal, all rights reserved. Commercial use requires license.
 
 #include "Draw.h"
+#include "GLState.h"
 #include "IO.h"
 #include <fstream>
 #include <string.h>
@@ -29,7 +30,7 @@ void LoadTexture(unsigned char *pixels, int width, int height, int bpp, unsigned
 				for (int k = 0; k < 3; k++)
 					*t++ = *p++;
 	}
-	glBindTexture(GL_TEXTURE_2D, textureName);      // bind current texture to textureName
+	BindTexture(GL_TEXTURE_2D, textureName);      // bind current texture to textureName
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);          // accommodate width not multiple of 4
 	// specify target, format, dimension, transfer data
 	if (bpp == 4)
@@ -45,7 +46,7 @@ void LoadTexture(unsigned char *pixels, int width, int height, int bpp, unsigned
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	if (false && bpp == 4) delete [] temp;
-	glBindTexture(GL_TEXTURE_2D, 0); // **** ???
+	BindTexture(GL_TEXTURE_2D, 0); // **** ???
 }
 
 GLuint LoadTexture(unsigned char *pixels, int width, int height, int bpp, bool bgr, bool mipmap) {
@@ -3,15 +3,17 @@
 
 #include <glad.h>
 #include "Draw.h"
+#include "GLState.h"
 #include "GLXtras.h"
 #include "IO.h"
 #include "Letters.h"
 #include <stdio.h>
+#include <vector>
 
 namespace {
 
 // images are 13 lines, each with 284 grayscale values; a value is represented as two hexadecimal characters
-const char *lowerCaseImage = "\
+constexpr char lowerCaseImage[] = "\
 FFFFFFFFFFFFFFFFFFD8000000D8FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF3B00007AFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFB90000000000FFFFFFFFFFFFFFFFFFFFFFFF3B00005CFFFFFFFFFFFFFFFFFFFFFF0000D8FFFFFFFFFFFFFFFFD80000D8FFFFFF9B000000FFFFFFFFFFFFFFFFD8000000009BFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF5C1DFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF\
 FFFFFFFFFFFFFFFFFFD8000000D8FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF3B00007AFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD8000000000000B9FFFFFFFFFFFFFFFFFFFFFF3B00005CFFFFFFFFFFFFFFFFFFFFFF0000D8FFFFFFFFFFFFFFFFD80000D8FFFFFF9B000000FFFFFFFFFFFFFFFFD8000000009BFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF1D00FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF\
 FFFFFFFFFFFFFFFFFFFFFF3B00D8FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF9B007AFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF9B007AFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFB9005CFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF1D00FFFFFFFFFFFFFFFFFFFFFF7A009BFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF1D00FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF\
@@ -26,7 +28,7 @@ FF1D000000B90000009D000000D800000000D8FFFFFFFFFF1D000000001DFFFFFFFF9B000000009B
 FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF1D00D8FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF1D00B9FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF3B00D8FFFFFFFFFFFFFFFFFFFFFFFFFFFF9B007AFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF9B003BFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF\
 FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF7A00000000003BFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF9B00000000001DFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD800000000009BFFFFFFFFFFFFFFFFFFFF7A0000000000FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF5C00000000005CFFFFFFFFFFFFFFFFFFFFFFFFFFFF";
 
-const char *upperCaseImage = "\
+constexpr char upperCaseImage[] = "\
 FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF\
 7A000000009BFFFFFFFF3B00000000000000FFFFFFFFFFFF5C0000009B5C1DFF1D000000000000B9FFFFFF3B00000000000000005CFFD80000000000000000009BFFFFFF5C0000009B5C3BFFB90000001DFF00000000B9FF7A00000000000000B9FFFFFFFF9B000000000000005C000000B9FF7A0000003B9B00000000001DFFFFFFD8000000D8FFFFFF9B0000000000009BFFD8000000005CFFFFFF5C0000007AFFFFFFFF1D0000000000005CFFFFFFFFFF5C0000007AFFFFFF3B0000000000001DFFFFFFFFFFFF3B000000B900B9FFB9000000000000000000D81D00003BFFFFFF0000000000000000B9FF9B00000000000000007AFF5C000000003B0000007AFF5C0000005C3B0000009BFF9B0000005CFF9B00000000000000B9\
 7A000000001DFFFFFFFF3B0000000000000000D8FFFFFF0000000000000000FF1D000000000000007AFFFF3B00000000000000005CFFD80000000000000000009BFFFF1D00000000000000FFB90000001DFF00000000B9FF7A00000000000000B9FFFFFFFF9B000000000000005C000000B9FF7A0000003B9B00000000001DFFFFFFD80000005CFFFFFF3B00000000000000FFD8000000005CFFFF0000000000001DFFFFFF1D000000000000003BFFFFFF0000000000001DFFFF3B0000000000000000FFFFFFFF1D0000000000009BFFB9000000000000000000D81D00003BFFFFFF0000000000000000B9FF9B00000000000000007AFF5C000000003B0000007AFF5C0000005C3B0000007AFF9B0000005CFF9B00000000000000B9\
@@ -42,7 +44,7 @@ D80000000000001DFFFFFFB9005CFFFFFFB90000D8B9007AFFFFFFFFFFFFFFFFFF3B00D8FFFFFFFF
 FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF1D000000D8D800B9FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF";
 
 // next 10 lines each with 82 grayscale values, each value represented as two hexadecimal characters
-const char *numberImage = "\
+constexpr char numberImage[] = "\
 FFEC7A110034C3FFFFDD98340047FFFFFFFFA723002389FFFFFF000000117AFFFFFFFFFFC3000089FFFF890000000000FFFFFFFFA734000089FF89000000000000C3FFDD57000023A7FFFFEC69110034B5FF\
 FF470000000011DDFF5700000047FFFFFF980000000000B5FFFF000000000098FFFFFFFF23000089FFFF890000000000FFFFFF690000000089FF89000000000000C3FF340000000000D0FF470000000000DD\
 D00011DDFF690069FF987AB50047FFFFFFEC47DDFF89007AFFFFFFFFFF980047FFFFFF89007A0089FFFF8900C3FFFFFFFFFFC30023B5FFFFFFFFFFFFFFFFEC1123FFFF0034ECFFA700C3DD0023DDFF890089\
@@ -54,6 +56,42 @@ B50034DDEC57007AFFFFFFC30047FFFFFFFF690089FFFFFFFFFFFFFFFFDD2300DD47000000000000
 FF340000000011DDFF47000000000047FF98000000000000FFC3000000000047FFFFFFFFFFC30089FFFF470000000011DDFFDD000000000047FFFFEC1111ECFFFFFFEC110000000000C3FF470000000069FF\
 FFEC69000057D0FFFF47000000000047FF89000000000000FFC30000003489ECFFFFFFFFFFC30089FFFF4700001169DDFFFFFFB534001169ECFFFF890089FFFFFFFFFFC334000034B5FFFF4700003498FFFF";
 
+// the three images decoded at compile time into one single-channel atlas:
+// lower case in rows 0-12, upper case in rows 14-26, numbers in rows 28-37;
+// a white row separates them so filtering doesn't bleed between images, and
+// the block right of the numbers is black, a solid texel for punctuation strokes
+const int atlasWidth = 284, atlasHeight = 38, lowerRow = 0, upperRow = 14, numberRow = 28;
+const int letterWidth = 284, letterHeight = 13, numberWidth = 82, numberHeight = 10, solidColumn = 84;
+
+struct GlyphAtlas { unsigned char pixels[atlasWidth*atlasHeight]; };
+
+constexpr int Hex(char c) { return c < 58? c-'0' : 10+c-'A'; }
+
+template<int N>
+constexpr void Decode(const char (&hex)[N], int width, int height, int row, GlyphAtlas &a) {
+	for (int j = 0; j < height; j++)
+		for (int i = 0; i < width; i++) {
+			int k = 2*(j*width+i);
+			a.pixels[(row+j)*atlasWidth+i] = (unsigned char) (16*Hex(hex[k])+Hex(hex[k+1]));
+		}
+}
+
+constexpr GlyphAtlas MakeGlyphAtlas() {
+	GlyphAtlas a = {};
+	for (int i = 0; i < atlasWidth*atlasHeight; i++)
+		a.pixels[i] = i/atlasWidth >= numberRow && i%atlasWidth >= solidColumn? 0 : 255;
+	Decode(lowerCaseImage, letterWidth, letterHeight, lowerRow, a);
+	Decode(upperCaseImage, letterWidth, letterHeight, upperRow, a);
+	Decode(numberImage, numberWidth, numberHeight, numberRow, a);
+	return a;
+}
+
+constexpr GlyphAtlas glyphAtlas = MakeGlyphAtlas();
+
+static_assert(sizeof(lowerCaseImage) == 2*letterWidth*letterHeight+1, "lower case image size");
+static_assert(sizeof(upperCaseImage) == 2*letterWidth*letterHeight+1, "upper case image size");
+static_assert(sizeof(numberImage) == 2*numberWidth*numberHeight+1, "number image size");
+
 // transform 2D vertex by view, separate uv from vec4
 const char *vertexShader = R"(
 	#version 130
@@ -79,69 +117,65 @@ const char *pixelShader = R"(
 	}
 )";
 
-GLuint shaderProgram = 0, vBufferId = 0;
-GLuint textureNameLower = 0, textureNameUpper = 0, textureNameNumber = 0;
-int textureUnitLower = 2, textureUnitUpper = 3, textureUnitNumber = 4; // this dies if GLUint?!
+GLuint shaderProgram = 0, vBufferId = 0, textureName = 0;
+int textureUnit = 2;
+std::vector<float> vertices; // x, y, u, v per vertex, two triangles per quad
 
-} // end namespace
-
-int MakeLetterTexture(unsigned char *image) {
-	// create and load texture raster
-	int nchars = (int) strlen(lowerCaseImage), npixels = nchars/2, height = 13, width = npixels/height;
-	unsigned char *pixels = new unsigned char[3*npixels], *p = pixels, *n = (unsigned char *) image;
-	for (int i = 0; i < npixels; i++) {
-		char c1 = *n++, c2 = *n++;
-		int k1 = c1 < 58? c1-'0' : 10+c1-'A', k2 = c2 < 58? c2-'0' : 10+c2-'A', b = 16*k1+k2;
-		for (int k = 0; k < 3; k++)
-			*p++ = (unsigned char) b;
+void Quad(vec2 p0, vec2 p1, vec2 p2, vec2 p3, vec2 uv0, vec2 uv1, vec2 uv2, vec2 uv3) {
+	vec2 p[] = {p0, p1, p2, p0, p2, p3}, uv[] = {uv0, uv1, uv2, uv0, uv2, uv3};
+	for (int i = 0; i < 6; i++) {
+		float v[] = {p[i].x, p[i].y, uv[i].x, uv[i].y};
+		vertices.insert(vertices.end(), v, v+4);
 	}
-	int textureName = LoadTexture(pixels, width, height, 3);
-	delete [] pixels;
-	return textureName;
 }
 
-int MakeNumberTexture(unsigned char *image) {
-	// create and load texture raster
-	int nchars = (int) strlen(numberImage), npixels = nchars/2, height = 10, width = npixels/height;
-	unsigned char *pixels = new unsigned char[3*npixels], *p = pixels, *n = (unsigned char *) image;
-	for (int i = 0; i < npixels; i++) {
-		char c1 = *n++, c2 = *n++;
-		int k1 = c1 < 58? c1-'0' : 10+c1-'A', k2 = c2 < 58? c2-'0' : 10+c2-'A', b = 16*k1+k2;
-		for (int k = 0; k < 3; k++)
-			*p++ = (unsigned char) b;
+void Stroke(float x1, float y1, float x2, float y2, float width) {
+	// line as a quad textured by the solid texel
+	vec2 a(x1, y1), b(x2, y2), d = b-a;
+	float len = length(d);
+	if (len <= 0) return;
+	vec2 n = (.5f*width/len)*vec2(-d.y, d.x);
+	vec2 s((solidColumn+100.5f)/atlasWidth, (numberRow+5.f)/atlasHeight);
+	Quad(a-n, b-n, b+n, a+n, s, s, s, s);
+}
+
+void Dot(float x, float y, float diameter) {
+	// octagon fan, as triangles, textured by the solid texel
+	vec2 s((solidColumn+100.5f)/atlasWidth, (numberRow+5.f)/atlasHeight), c(x, y);
+	float r = diameter/2;
+	for (int i = 0; i < 8; i++) {
+		float a1 = 3.1415926f*i/4, a2 = 3.1415926f*(i+1)/4;
+		vec2 p1 = c+r*vec2(cos(a1), sin(a1)), p2 = c+r*vec2(cos(a2), sin(a2));
+		float v[][4] = { {c.x, c.y, s.x, s.y}, {p1.x, p1.y, s.x, s.y}, {p2.x, p2.y, s.x, s.y} };
+		vertices.insert(vertices.end(), &v[0][0], &v[0][0]+12);
 	}
-	int textureName = LoadTexture(pixels, width, height, 3);
-	delete [] pixels;
-	return textureName;
 }
 
-void Letter(int x, int y, char c, vec3 color, float ptSize) {
+void AddLetter(float x, float y, char c, float ptSize) {
+	// append character c, lower-left at (x, y), to vertices
 	if (c < 48 || c == 61 || c == 94) { // 32(space), 40((), 41()), 43(+), 45(-), 46(.), 47(/), 61(=), 94(^)
-		float lineWidth = 4; // ptSize/3; // = 2;
-		UseDrawShader(ScreenMode());
-		int size = (int) ptSize, h = (int)(ptSize*.5f), hh = (int)(ptSize*.75f);
+		float lineWidth = 4, size = (float) (int) ptSize, h = (float) (int) (ptSize*.5f);
+		float y25 = y+(int)(.25f*ptSize), y75 = y+(int)(.75f*ptSize);
 		if (c == 40) {
-			vec2 p1(x+h, y+size+1), p2(x+2, y+(int)(.75f*ptSize)), p3(x+2, y+(int)(.25f*ptSize)), p4(x+h, y-1);
-			Line(p1, p2, lineWidth, color); Line(p2, p3, lineWidth, color); Line(p3, p4, lineWidth, color);
+			Stroke(x+h, y+size+1, x+2, y75, lineWidth); Stroke(x+2, y75, x+2, y25, lineWidth); Stroke(x+2, y25, x+h, y-1, lineWidth);
 		}
 		if (c == 41) {
-			vec2 p1(x+h, y+size+1), p2(x+size-2, y+(int)(.75f*ptSize)), p3(x+size-2, y+(int)(.25f*ptSize)), p4(x+h, y-1);
-			Line(p1, p2, lineWidth, color); Line(p2, p3, lineWidth, color); Line(p3, p4, lineWidth, color);
+			Stroke(x+h, y+size+1, x+size-2, y75, lineWidth); Stroke(x+size-2, y75, x+size-2, y25, lineWidth); Stroke(x+size-2, y25, x+h, y-1, lineWidth);
 		}
 		if (c == 61) {
-			Line(x+1, y+h+3, x+h+6, y+h+3, lineWidth, color);
-			Line(x+1, y+h-3, x+h+6, y+h-3, lineWidth, color);
+			Stroke(x+1, y+h+3, x+h+6, y+h+3, lineWidth);
+			Stroke(x+1, y+h-3, x+h+6, y+h-3, lineWidth);
 		}
 		if (c == 43) {
-			Line(x+1, y+h+1, x+h+6, y+h+1, lineWidth, color);
-			Line(x+h, y+2, x+h, y+h+6, lineWidth, color);
+			Stroke(x+1, y+h+1, x+h+6, y+h+1, lineWidth);
+			Stroke(x+h, y+2, x+h, y+h+6, lineWidth);
 		}
-		if (c == 45) Line(x+1, y+h, x+h+3, y+h, lineWidth, color);
-		if (c == 46) Disk(vec2(x+h, y+3), ptSize/3, color);
-		if (c == 47) Line(x+1, y, x+size-1, y+size, lineWidth, color);
+		if (c == 45) Stroke(x+1, y+h, x+h+3, y+h, lineWidth);
+		if (c == 46) Dot(x+h, y+3, ptSize/3);
+		if (c == 47) Stroke(x+1, y, x+size-1, y+size, lineWidth);
 		if (c == 94) {
-			Line(x+1, y+2, x+h, y+h+4, lineWidth, color);
-			Line(x+h, y+h+4, x+size-2, y+2, lineWidth, color);
+			Stroke(x+1, y+2, x+h, y+h+4, lineWidth);
+			Stroke(x+h, y+h+4, x+size-2, y+2, lineWidth);
 		}
 		return;
 	}
@@ -152,86 +186,79 @@ void Letter(int x, int y, char c, vec3 color, float ptSize) {
 							 Unknown;
 	if (type == Unknown)
 		return;
-	if (!textureNameLower)
-		textureNameLower = MakeLetterTexture((unsigned char *) lowerCaseImage);//, textureUnitLower);
-	if (!textureNameUpper)
-		textureNameUpper = MakeLetterTexture((unsigned char *) upperCaseImage);//, textureUnitUpper);
-	if (!textureNameNumber)
-		textureNameNumber = MakeNumberTexture((unsigned char *) numberImage);//, textureUnitNumber);
-	if (!textureNameLower || !textureNameUpper || !textureNameNumber)
-		printf("can't make texture maps\n");
+	// value determines horizontal position along its image
+	float w = .8f*ptSize, h = ptSize;
+	int id = type == Upper? c-'A' : type == Lower? c-'a' : c-'0', n = type == Number? 10 : 26;
+	int row = type == Upper? upperRow : type == Lower? lowerRow : numberRow;
+	int imageWidth = type == Number? numberWidth : letterWidth, imageHeight = type == Number? numberHeight : letterHeight;
+	float s0 = (float) imageWidth*id/n/atlasWidth, s1 = (float) imageWidth*(id+1)/n/atlasWidth;
+	float t0 = (float) row/atlasHeight, t1 = (float) (row+imageHeight)/atlasHeight;
+	Quad(vec2(x, y), vec2(x+w, y), vec2(x+w, y+h), vec2(x, y+h), vec2(s0, t1), vec2(s1, t1), vec2(s1, t0), vec2(s0, t0));
+}
+
+void DrawLetters(float x, float y, const char *letters, vec3 color, float ptSize) {
+	// one vertex stream for the whole string, one draw
+	vertices.resize(0);
+	for (int i = 0; letters[i]; i++)
+		AddLetter((float) (int) (x+i*ptSize), (float) (int) y, letters[i], ptSize);
+	if (vertices.empty())
+		return;
+	if (!textureName) {
+		glGenTextures(1, &textureName);
+		BindTexture(GL_TEXTURE_2D, textureName);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasWidth, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, glyphAtlas.pixels);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
 	if (!shaderProgram)
 		shaderProgram = LinkProgramViaCode(&vertexShader, &pixelShader);
-	glUseProgram(shaderProgram);
-	if (!vBufferId) {
+	UseProgram(shaderProgram);
+	if (!vBufferId)
 		glGenBuffers(1, &vBufferId);
-		glBindBuffer(GL_ARRAY_BUFFER, vBufferId);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(float)*4*6, NULL, GL_DYNAMIC_DRAW);
-			// need 4 vertices for quad, but 6 if triangles
-	}
-	glBindBuffer(GL_ARRAY_BUFFER, vBufferId);
+	BindBuffer(GL_ARRAY_BUFFER, vBufferId);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size()*sizeof(float), vertices.data(), GL_STREAM_DRAW);
 	VertexAttribPointer(shaderProgram, "point", 4, 4*sizeof(float), 0);
 		// each vertex is 4 floats, stride is 4 floats
-	int texUnit = type == Upper? textureUnitUpper : type == Lower? textureUnitLower : textureUnitNumber;
-	GLuint texName = type == Upper? textureNameUpper : type == Lower? textureNameLower : textureNameNumber;
-	glActiveTexture(GL_TEXTURE0+texUnit);
-	glBindTexture(GL_TEXTURE_2D, texName);
+	ActiveTexture(GL_TEXTURE0+textureUnit);
+	BindTexture(GL_TEXTURE_2D, textureName);
 	// set screen-mode
 	SetUniform(shaderProgram, "view", ScreenMode());
 	// set text color and texture map, activate texture
 	SetUniform(shaderProgram, "color", color);
-	SetUniform(shaderProgram, "textureImage", texUnit);
+	SetUniform(shaderProgram, "textureImage", textureUnit);
 	// enable blended overwrite of color buffer
-	glEnable(GL_BLEND);
+	Enable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	// display character c, value determines horizontal position along texture
-	float w = .8f*ptSize, h = ptSize, xx = (float) x, yy = (float) y;
-	float t = 0, dt = 0;
-	if (type == Number) {
-		int value = c-'0';
-		dt = 1.f/10.f; t = (float) value*dt;
-		float vertices[][4] = { {xx, yy, t, 1}, {xx+w, yy, t+dt, 1}, {xx+w, yy+h, t+dt, 0}, {xx, yy+h, t, 0} };
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-	}
-	else {
-		int letterID = type == Upper? c-'A' : type == Lower? c-'a' : c-'0';
-		dt = 1.f/26.f; t = (float)letterID*dt;
-	//	float vertices[][4] = { {xx, yy+h, t, 1}, {xx+w, yy+h, t+dt, 1}, {xx+w, yy, t+dt, 0}, {xx, yy, t, 0} };
-		float vertices[][4] = { {xx, yy, t, 1}, {xx+w, yy, t+dt, 1}, {xx+w, yy+h, t+dt, 0}, {xx, yy+h, t, 0} };
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-	}
-	// display as one quad or two triangles, mapped to 1/26 width of texture map
-#ifndef __APPLE__
-	glDrawArrays(GL_QUADS, 0, 4);
-#else
-	float vertices[][4] = {{xx, yy, t, 1}, {xx+w, yy, t+dt, 1},   {xx+w, yy+h, t+dt, 0},
-					       {xx, yy, t, 1}, {xx+w, yy+h, t+dt, 0}, {xx, yy+h, t, 0}};
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-	glDrawArrays(GL_TRIANGLES, 0, 6);
-#endif
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei) vertices.size()/4);
+	BindVertexArray(0);
+	BindTexture(GL_TEXTURE_2D, 0);
+}
+
+} // end namespace
+
+void Letter(int x, int y, char c, vec3 color, float ptSize) {
+	char letters[] = {c, 0};
+	DrawLetters((float) x, (float) y, letters, color, ptSize);
 }
 
 void Letters(int x, int y, const char *letters, vec3 color, float ptSize) {
-	int was = 0;
+	GLuint was = BoundProgram();
 	mat4 drawView = GetDrawView();
-	glGetIntegerv(GL_CURRENT_PROGRAM, &was);
-	for (int i = 0; i < (int) strlen(letters); i++)
-		Letter((int) (x+i*ptSize), y, letters[i], color, ptSize);
-	glUseProgram(was);
+	DrawLetters((float) x, (float) y, letters, color, ptSize);
+	UseProgram(was);
 	SetDrawView(drawView);
 }
 
 void Letters(vec3 p, mat4 m, const char *letters, vec3 color, float ptSize) {
-	int was = 0;
+	GLuint was = BoundProgram();
 	mat4 drawView = GetDrawView();
-	glGetIntegerv(GL_CURRENT_PROGRAM, &was);
 	vec2 pp = ScreenPoint(p, m);
-	for (int i = 0; i < (int) strlen(letters); i++)
-	//	Letter((int) (pp.x+i*10.9f), (int) pp.y, letters[i], color, ptSize);
-		Letter((int) (pp.x+i*ptSize), (int) pp.y, letters[i], color, ptSize);
-	glUseProgram(was);
+	DrawLetters(pp.x, pp.y, letters, color, ptSize);
+	UseProgram(was);
 	SetDrawView(drawView);
 }
 
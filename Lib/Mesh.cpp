@@ -1,6 +1,7 @@
 // Mesh.cpp - mesh operations
 // Copyright (c) 2024 Jules Bloomenthal, all rights reserved. Commercial use requires license.
 
+#include "GLState.h"
 #include "GLXtras.h"
 #include "Draw.h"
 #include "Mesh.h"
@@ -219,7 +220,7 @@ GLuint GetMeshShader(bool lines) {
 
 GLuint UseMeshShader(bool lines) {
 	GLuint s = GetMeshShader(lines);
-	glUseProgram(s);
+	UseProgram(s);
 	return s;
 }
 
@@ -305,13 +306,13 @@ void Mesh::Display(Camera camera, int textureUnit, bool lines, bool useGroupColo
 	int nTris = triangles.size(), nQuads = quads.size();
 	// enable shader and vertex array object
 	int shader = UseMeshShader(lines);
-	glBindVertexArray(vao);
+	BindVertexArray(vao);
 	// texture
 	bool useTexture = textureName > 0 && uvs.size() > 0 && textureUnit >= 0;
 	SetUniform(shader, "useTexture", useTexture);
 	if (useTexture) {
-		glActiveTexture(GL_TEXTURE0+textureUnit);
-		glBindTexture(GL_TEXTURE_2D, textureName);
+		ActiveTexture(GL_TEXTURE0+textureUnit);
+		BindTexture(GL_TEXTURE_2D, textureName);
 		SetUniform(shader, "textureImage", textureUnit); // but app can unset useTexture
 	}
 	// set matrices
@@ -319,16 +320,14 @@ void Mesh::Display(Camera camera, int textureUnit, bool lines, bool useGroupColo
 	SetUniform(shader, "persp", camera.persp);
 	if (lines)
 		SetUniform(shader, "vp", Viewport());
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
 	if (useGroupColor) {
-		int textureSet = 0;
-		glGetUniformiv(shader, glGetUniformLocation(shader, "useTexture"), &textureSet);
 		// show ungrouped triangles without texture mapping
 		int nGroups = triangleGroups.size(), nUngrouped = nGroups? triangleGroups[0].startTriangle : nTris;
 		SetUniform(shader, "useTexture", false);
 		glDrawElements(GL_TRIANGLES, 3*nUngrouped, GL_UNSIGNED_INT, 0); // triangles.data());
 		// show grouped triangles with texture mapping
-		SetUniform(shader, "useTexture", textureSet == 1);
+		SetUniform(shader, "useTexture", useTexture);
 		for (int i = 0; i < nGroups; i++) {
 			Group g = triangleGroups[i];
 			SetUniform(shader, "color", g.color);
@@ -339,12 +338,12 @@ void Mesh::Display(Camera camera, int textureUnit, bool lines, bool useGroupColo
 		SetUniform(shader, "color", color);
 		glDrawElements(GL_TRIANGLES, 3*nTris, GL_UNSIGNED_INT, 0);
 #ifndef __APPLE__
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 		glDrawElements(GL_QUADS, 4*nQuads, GL_UNSIGNED_INT, quads.data());
 #endif
 	}
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	BindVertexArray(0);
 }
 
 // Buffering
@@ -360,7 +359,7 @@ void Mesh::Buffer(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *tex) {
 	// create vertex buffer
 	if (!vbo)
 		glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	BindBuffer(GL_ARRAY_BUFFER, vbo);
 	// allocate GPU memory for vertex position, texture, normals
 	size_t sizePoints = nPts*sizeof(vec3), sizeNormals = nNrms*sizeof(vec3), sizeUvs = nUvs*sizeof(vec2);
 	int bufferSize = sizePoints+sizeUvs+sizeNormals;
@@ -372,17 +371,17 @@ void Mesh::Buffer(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *tex) {
 	// create and load element buffer for triangles
 	size_t sizeTriangles = sizeof(int3)*triangles.size();
 	glGenBuffers(1, &ebo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeTriangles, triangles.data(), GL_STATIC_DRAW);
 	// create vertex array object for mesh
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	BindVertexArray(vao);
 	// enable attributes
 	if (nPts) Enable(0, 3, 0);						// VertexAttribPointer(shader, "point", 3, 0, (void *) 0);
 	if (nNrms) Enable(1, 3, sizePoints);			// VertexAttribPointer(shader, "normal", 3, 0, (void *) sizePoints);
 	if (nUvs) Enable(2, 2, sizePoints+sizeNormals); // VertexAttribPointer(shader, "uv", 2, 0, (void *) (sizePoints+sizeNormals));
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	BindBuffer(GL_ARRAY_BUFFER, 0);
+	BindVertexArray(0);
 }
 
 void Mesh::Clear() {
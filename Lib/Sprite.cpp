@@ -2,10 +2,12 @@
 // Copyright (c) 2024 Jules Bloomenthal, all rights reserved. Commercial use requires license.
 
 #include "Draw.h"
+#include "GLState.h"
 #include "GLXtras.h"
 #include "IO.h"
 #include "Sprite.h"
 #include <algorithm>
+#include <chrono>
 
 // Shader storage buffers for collision tests
 GLuint occupyBinding = 11, collideBinding = 12;
@@ -107,6 +109,12 @@ bool CrossPositive(vec2 a, vec2 b, vec2 c) {
 	return cross(vec2(b-a), vec2(c-b)) > 0;
 }
 
+time_t Now() {
+	// monotonic milliseconds; clock() counts CPU time, which stalls while waiting on vsync
+	using namespace std::chrono;
+	return (time_t) duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
 } // end namespace
 
 // Collision
@@ -117,15 +125,15 @@ GLuint		spriteCountersBuf = 0;
 
 void ResetCounter() {
 	GLuint count = 0;
-	glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, spriteCountersBuf);
-	glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, spriteCountersBuf);
+	BindBuffer(GL_ATOMIC_COUNTER_BUFFER, spriteCountersBuf);
+	BindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, spriteCountersBuf);
 	glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), &count);
 }
 
 int ReadCounter() {
 	GLuint count = 0;
-	glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, spriteCountersBuf);
-	glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, spriteCountersBuf);
+	BindBuffer(GL_ATOMIC_COUNTER_BUFFER, spriteCountersBuf);
+	BindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, spriteCountersBuf);
 	glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), &count);
 	return count; // # pixels collided
 }
@@ -136,34 +144,34 @@ void InitCollisionShaderStorage(int nsprites) {
 	// occupancy buffer
 	clearOccupy.assign(w*h, -1);
 	glGenBuffers(1, &occupyBuffer);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, occupyBinding, occupyBuffer);
+	BindBufferBase(GL_SHADER_STORAGE_BUFFER, occupyBinding, occupyBuffer);
 	glBufferData(GL_SHADER_STORAGE_BUFFER, w*h*sizeof(int), clearOccupy.data(), GL_DYNAMIC_DRAW);
 	// collision buffer
 	clearCollide.assign(nsprites, -1);
 	glGenBuffers(1, &collideBuffer);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, collideBinding, collideBuffer);
+	BindBufferBase(GL_SHADER_STORAGE_BUFFER, collideBinding, collideBuffer);
 	glBufferData(GL_SHADER_STORAGE_BUFFER, nsprites*sizeof(int), clearCollide.data(), GL_DYNAMIC_DRAW);
 	// atomic counters
 	glGenBuffers(1, &spriteCountersBuf);
-	glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, spriteCountersBuf);
-	glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, spriteCountersBuf);
+	BindBuffer(GL_ATOMIC_COUNTER_BUFFER, spriteCountersBuf);
+	BindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, spriteCountersBuf);
 	glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint), NULL, GL_DYNAMIC_DRAW);
-	glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, 0);
-	glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+	BindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, 0);
+	BindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
 }
 
 void ClearCollide() {
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, collideBinding, collideBuffer);
+	BindBufferBase(GL_SHADER_STORAGE_BUFFER, collideBinding, collideBuffer);
 	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, clearCollide.size()*sizeof(int), clearCollide.data());
 }
 
 void ClearOccupyAndCounter(int nsprites) {
 	int w = VPw(), h = VPh();
 	// occupancy buffer
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, occupyBinding, occupyBuffer);
+	BindBufferBase(GL_SHADER_STORAGE_BUFFER, occupyBinding, occupyBuffer);
 	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, w*h*sizeof(int), clearOccupy.data());
 	// collision buffer
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, collideBinding, collideBuffer);
+	BindBufferBase(GL_SHADER_STORAGE_BUFFER, collideBinding, collideBuffer);
 	// glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, clearCollide.size()*sizeof(int), clearCollide.data());
 	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, nsprites*sizeof(int), clearCollide.data());
 	// atomic counter
@@ -191,7 +199,7 @@ int TestCollisions(vector<Sprite *> &sprites) {
 		tmp[i]->id = i;
 	sort(tmp.begin(), tmp.end(), ZCompare);
 	GLuint program = SpriteSpace::GetCollisionShader();
-	glUseProgram(program);
+	UseProgram(program);
 	vec4 vp = VP();
 	SetUniform(program, "vp", vp);
 	SetUniform(program, "showOccupy", true);
@@ -205,7 +213,7 @@ int TestCollisions(vector<Sprite *> &sprites) {
 	}
 	SetUniform(program, "showOccupy", false);
 	UseDrawShader(ScreenMode());
-	glUseProgram(0);
+	UseProgram(0);
 	return ReadCounter();
 }
 
@@ -232,7 +240,7 @@ void Sprite::Initialize(GLuint texName, float z) {
 	this->z = z;
 	textureName = texName;
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	BindVertexArray(vao);
 	UpdateTransform();
 }
 
@@ -241,7 +249,7 @@ void Sprite::Initialize(string imageFile, float z, bool compensateAspectRatio) {
 	this->compensateAspectRatio = compensateAspectRatio;
 	textureName = ReadTexture(imageFile.c_str(), true, &nTexChannels, &imgWidth, &imgHeight);
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	BindVertexArray(vao);
 	UpdateTransform();
 }
 
@@ -261,9 +269,9 @@ void Sprite::Initialize(vector<string> &imageFiles, string matFile, float z, flo
 	}
 	if (!matFile.empty())
 		matName = ReadTexture(matFile.c_str());
-	change = clock()+(time_t)(frameDuration*CLOCKS_PER_SEC);
+	change = SpriteSpace::Now()+(time_t)(frameDuration*1000);
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	BindVertexArray(vao);
 	UpdateTransform();
 }
 
@@ -377,31 +385,31 @@ void Sprite::SetFrame(int n) {
 
 void Sprite::Display(mat4 *fullview, int textureUnit) {
 	int s = CurrentProgram();
-	glBindVertexArray(vao);
+	BindVertexArray(vao);
 	if (s <= 0 || (s != spriteShader && s != spriteCollisionShader))
 		s = SpriteSpace::GetShader();
-	glUseProgram(s);
-	glActiveTexture(GL_TEXTURE0+textureUnit);
+	UseProgram(s);
+	ActiveTexture(GL_TEXTURE0+textureUnit);
 	if (nFrames) {
-		time_t now = clock();
+		time_t now = SpriteSpace::Now();
 		ImageInfo i = images[frame];
 		if (autoAnimate && now > change) {
 			frame = (frame+1)%nFrames;
-			change = now+(time_t)(i.duration*CLOCKS_PER_SEC);
+			change = now+(time_t)(i.duration*1000);
 		}
-		glBindTexture(GL_TEXTURE_2D, i.textureName);
+		BindTexture(GL_TEXTURE_2D, i.textureName);
 		SetUniform(s, "nTexChannels", i.nChannels);
 	}
 	else {
-		glBindTexture(GL_TEXTURE_2D, textureName);
+		BindTexture(GL_TEXTURE_2D, textureName);
 		SetUniform(s, "nTexChannels", nTexChannels);
 	}
 	SetUniform(s, "textureImage", textureUnit);
 	SetUniform(s, "useMat", matName > 0);
 	SetUniform(s, "z", z);
 	if (matName > 0) {
-		glActiveTexture(GL_TEXTURE0+textureUnit+1);
-		glBindTexture(GL_TEXTURE_2D, matName);
+		ActiveTexture(GL_TEXTURE0+textureUnit+1);
+		BindTexture(GL_TEXTURE_2D, matName);
 		SetUniform(s, "textureMat", (int) textureUnit+1);
 	}
 	SetUniform(s, "view", fullview? *fullview*ptTransform : ptTransform);
@@ -420,9 +428,9 @@ void Sprite::SetFrameDuration(float dt) {
 
 void Sprite::Release() {
 	if (textureName > 0)
-		glDeleteBuffers(1, &textureName);
+		DeleteTextures(1, &textureName);
 	if (matName > 0)
-		glDeleteBuffers(1, &matName);
+		DeleteTextures(1, &matName);
 	for (ImageInfo i : images)
-		glDeleteBuffers(1, &i.textureName);
+		DeleteTextures(1, &i.textureName);
 }
@@ -4,6 +4,7 @@
 
 #include <glad.h>
 #include "Draw.h"
+#include "GLState.h"
 #include "GLXtras.h"
 #include "Letters.h"
 #include "Text.h"
@@ -96,7 +97,7 @@ void SetCharacterSet(CharacterSet &cs, const char *fontName, int charRes, int pi
 			// generate texture
 			GLuint texture;
 			glGenTextures(1, &texture);
-			glBindTexture(GL_TEXTURE_2D, texture);
+			BindTexture(GL_TEXTURE_2D, texture);
 			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, g->bitmap.width, g->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, g->bitmap.buffer);
 			// texture options
@@ -153,26 +154,26 @@ void RenderText(const char *text, float x, float y, vec3 color, float scale, mat
 	}
 	if (!textShaderProgram)
 		textShaderProgram = LinkProgramViaCode(&textVertexShader, &textPixelShader);
-	glUseProgram(textShaderProgram);
+	UseProgram(textShaderProgram);
 	scale /= (float) currentFont->charRes;
 	// create quad vertex buffer and build characters
 	if (textVertexBuffer == 0)
 		glGenBuffers(1, &textVertexBuffer);
-	glBindBuffer(GL_ARRAY_BUFFER, textVertexBuffer);
+	BindBuffer(GL_ARRAY_BUFFER, textVertexBuffer);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(float)*6*4, NULL, GL_DYNAMIC_DRAW);
 	VertexAttribPointer(textShaderProgram, "point", 4, 4*sizeof(float), 0);
 	SetUniform(textShaderProgram, "view", view);
 	SetUniform(textShaderProgram, "color", color);
 	// SetUniform(textShaderProgram, "textureImage", (int) textureID); // not needed? (defaults to 0?)
-	glActiveTexture(GL_TEXTURE0);
-	glBindBuffer(GL_ARRAY_BUFFER, textVertexBuffer);
-	glEnable(GL_BLEND);
+	ActiveTexture(GL_TEXTURE0);
+	BindBuffer(GL_ARRAY_BUFFER, textVertexBuffer);
+	Enable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	for (const char *c = text; *c; c++) {
 		Character ch = currentFont->characters[(int)*c];
 		float xpos = x+ch.bearing.i1*scale, ypos = y-(ch.gSize.i2-ch.bearing.i2)*scale;
 		float w = ch.gSize.i1*scale, h = ch.gSize.i2*scale;
-		glBindTexture(GL_TEXTURE_2D, ch.textureID);
+		BindTexture(GL_TEXTURE_2D, ch.textureID);
 		// update vertex memory
 #ifndef __APPLE__
 		float vertices[][4] = {{xpos, ypos+h, 0, 0}, {xpos+w, ypos+h, 1, 0}, {xpos+w, ypos, 1, 1}, {xpos, ypos, 0, 1}};
@@ -189,8 +190,8 @@ void RenderText(const char *text, float x, float y, vec3 color, float scale, mat
 		else
 			x += (ch.advance >> 6)*scale;     // advance character position in terms of 1/64 pixel
 	}
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	BindVertexArray(0);
+	BindTexture(GL_TEXTURE_2D, 0);
 }
 
 float TextWidth(float scale, const char *format, ...) {
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include <openvr.h>
+#include "GLState.h"
 #include "VRXtras.h"
 
 // see https://github.com/ValveSoftware/openvr/wiki/API-Documentation
@@ -224,10 +225,10 @@ void VROOM::SubmitOpenGLFrames(GLuint leftTextureUnit, GLuint rightTextureUnit)
 	EVRCompositorError err = VRCompositorError_None;
 	if (!VRCompositor())
 		return;
-	glBindTexture(GL_TEXTURE_2D, leftTextureUnit); // ?
+	BindTexture(GL_TEXTURE_2D, leftTextureUnit); // ?
 	err = VRCompositor()->Submit(Eye_Left, &leftEyeTexture);
 	if (err) printf("VRCompositor:Submit(left): %s\n", GetCompositorError(err));
-	glBindTexture(GL_TEXTURE_2D, rightTextureUnit); // ?
+	BindTexture(GL_TEXTURE_2D, rightTextureUnit); // ?
 	err = VRCompositor()->Submit(Eye_Right, &rightEyeTexture);
 	if (err) printf("VRCompositor:Submit(right): %s\n", GetCompositorError(err));
 	glFlush();
@@ -245,16 +246,16 @@ bool VROOM::InitFrameBuffer(int w, int h) {
 	glGenTextures(1, &framebufferTextureName);
 	glGenRenderbuffers(1, &depthBuffer);
 	// setup texture
-	glActiveTexture(GL_TEXTURE0+framebufferTextureName);
+	ActiveTexture(GL_TEXTURE0+framebufferTextureName);
 	if (multisample) {
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, framebufferTextureName);
+		BindTexture(GL_TEXTURE_2D_MULTISAMPLE, framebufferTextureName);
 		glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, 4, GL_RGBA, width, height, GL_TRUE);
 		glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	//	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+	//	BindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
 	}
 	else {
-		glBindTexture(GL_TEXTURE_2D, framebufferTextureName);
+		BindTexture(GL_TEXTURE_2D, framebufferTextureName);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_FLOAT, 0);
 	//	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -285,8 +286,8 @@ void VROOM::CopyFramebufferToEyeTexture(GLuint textureName, GLuint textureUnit)
 	// read from framebuffer
 	glReadPixels(0, 0, width, height, GL_RGBA, GL_FLOAT, pixels);
 	// store pixels as GL texture
-	glActiveTexture(GL_TEXTURE0+textureUnit);
-	glBindTexture(GL_TEXTURE_2D, textureName); // bind active texture to textureName
+	ActiveTexture(GL_TEXTURE0+textureUnit);
+	BindTexture(GL_TEXTURE_2D, textureName); // bind active texture to textureName
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);     // accommodate width not multiple of 4
 //	***** some Occulus devices reporting error: TextureUsesUnsupportedFormat
 //	***** OpenVR says: scene textures must be compatible with DXGI sharing rules - e.g. uncompressed, no mips, etc.
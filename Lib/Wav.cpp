@@ -3,9 +3,12 @@
 
 #include <glad.h>
 #include "Draw.h"
+#include "GLState.h"
 #include "Text.h"
 #include "Wav.h"
 #include "Widgets.h"
+#include <string.h>
+#include <vector>
  
 // read
 
@@ -20,12 +23,9 @@ void PrintWAV(const char *name, int format) {
 }
 
 bool Wav::Read(string filename, bool verbose) {
-	// **** see https://docs.microsoft.com/en-us/windows/win32/api/mmeapi/ns-mmeapi-waveformatex
-	//		fmt and riff do not indicate possible "chunks" (additional cuts) following audio
-	//		so, nSamples can be mistakenly high
-	//		**** for accurate nSamples, advanced parse of headers needed
-	//		**** or: import to Audacity, select all, export to .wav; then, reduce = 70 (see below) seems to work
-	//      only uncompressed audio supported here
+	// walk the RIFF chunks: fmt gives the format and data the exact number of samples;
+	// any others (LIST, fact, cue, ...) are skipped, whether before or after data
+	// only uncompressed 16-bit audio supported here
 	FILE *in = fopen(filename.c_str(), "rb");
 	if (!in) {
 		printf("  ** no such file: %s\n", filename.c_str());
@@ -36,9 +36,11 @@ bool Wav::Read(string filename, bool verbose) {
 		int fileSize;		// size of file in bytes less 8
 		int typeID;			// should be "WAVE" (waveform audio file format)
 	} r;
-	struct FmtHeader {
-		int waveID;			// should be "fmt"
-		int headerSize;		// in bytes (less 4), should be 16 unless "extra" bytes
+	struct ChunkHeader {
+		int chunkID;		// "fmt ", "data", "LIST", ...
+		int chunkSize;		// in bytes, less this header and any pad byte
+	} c;
+	struct FmtChunk {
 		short compression;
 		short nChannels;
 		int samplingRate;
@@ -46,27 +48,47 @@ bool Wav::Read(string filename, bool verbose) {
 		short blockAlign;
 		short sigBitsPerSamp;
 	} fmt;
-	int nRiffRead = fread(&r, sizeof(RiffHeader), 1, in);
-	int nFmtRead = fread(&fmt, sizeof(FmtHeader), 1, in);
-	if (nRiffRead != 1 || nFmtRead != 1) {
-			printf("  ** can't read header (%s)\n", filename.c_str());
-			fclose(in);
-			return false;
+	if (fread(&r, sizeof(RiffHeader), 1, in) != 1 || memcmp(&r.fileID, "RIFF", 4) || memcmp(&r.typeID, "WAVE", 4)) {
+		printf("  ** not a RIFF/WAVE file (%s)\n", filename.c_str());
+		fclose(in);
+		return false;
 	}
 	if (verbose) {
 		printf("%s:\n", filename.c_str());
 		PrintWAV("  fileID", r.fileID);
 		PrintWAV("  typeID", r.typeID);
-		PrintWAV("  waveID", fmt.waveID);
 		printf("  file size: %i\n", r.fileSize);
-		printf("  header size: %i\n", fmt.headerSize);
+	}
+	bool haveFmt = false, haveData = false;
+	unsigned int nDataBytes = 0;
+	while (!haveData && fread(&c, sizeof(ChunkHeader), 1, in) == 1) {
+		unsigned int size = (unsigned int) c.chunkSize;
+		long next = ftell(in)+size+(size&1); // chunks are padded to even length
+		if (verbose) {
+			PrintWAV("  chunk", c.chunkID);
+			printf("  chunk size: %u\n", size);
+		}
+		if (!memcmp(&c.chunkID, "fmt ", 4) && size >= sizeof(FmtChunk))
+			haveFmt = fread(&fmt, sizeof(FmtChunk), 1, in) == 1;
+		if (!memcmp(&c.chunkID, "data", 4)) {
+			haveData = true;	// leave the file at the first sample
+			nDataBytes = size;
+		}
+		else
+			fseek(in, next, SEEK_SET);
+	}
+	if (!haveFmt || !haveData) {
+		printf("  ** no %s chunk (%s)\n", haveFmt? "data" : "fmt", filename.c_str());
+		fclose(in);
+		return false;
+	}
+	if (verbose) {
 		printf("  compression: %i\n", fmt.compression);
 		printf("  # channels: %i\n", fmt.nChannels);
 		printf("  sampling rate: %i\n", fmt.samplingRate);
 		printf("  aveBytes/sec: %i\n", fmt.aveBytesPerSec);
 		printf("  block align: %i\n", fmt.blockAlign);
 		printf("  sigBits/samp: %i\n", fmt.sigBitsPerSamp);
-		printf("  RiffHeader %i bytes, FmtHeader %i bytes\n", sizeof(RiffHeader), sizeof(FmtHeader));
 	}
 	// needed by Wav
 	nChannels = fmt.nChannels;
@@ -75,30 +97,18 @@ bool Wav::Read(string filename, bool verbose) {
 	blockAlign = fmt.blockAlign;
 	sigBitsPerSamp = fmt.sigBitsPerSamp;
 	// validity checks
-	if (nChannels < 1 || nChannels > 2)
-		printf("  ** %i channels!\n", fmt.nChannels);
-	if (sigBitsPerSamp != 16)
-		printf("  ** %i bits per sample!\n", fmt.sigBitsPerSamp);
+	if (fmt.compression != 1 || sigBitsPerSamp != 16 || nChannels < 1 || nChannels > 2) {
+		printf("  ** unsupported: compression %i, %i channels, %i bits per sample (%s)\n",
+			fmt.compression, nChannels, sigBitsPerSamp, filename.c_str());
+		fclose(in);
+		return false;
+	}
 	if (blockAlign/nChannels != 2)
 		printf("  ** blockAlign = %i!\n", fmt.blockAlign);
-	if (fmt.headerSize > 16) {
-		short nExtraFormatBytes;
-		if (fread(&nExtraFormatBytes, 2, 1, in) == 1) {
-			char buf[100];
-			fread(buf, nExtraFormatBytes, 1, in);
-			if (verbose) 
-				printf("  ** %i extra bytes in Wave header\n", nExtraFormatBytes);
-		}
-	}
-	// read samples
-	int reduce = 70;
-		// *** determined empirically to compensate for possible
-		// *** "chunks" following audio data not indicated by fmt or riff
-	int nSampleBytes = r.fileSize-sizeof(RiffHeader)-sizeof(FmtHeader);
-	nSamples = nSampleBytes/(nChannels*sizeof(short))-reduce;
-	int nShorts = nChannels*nSamples, bytesPerSample = nChannels*sizeof(short);
-	samples.reserve(nShorts);
-	samples.resize(nShorts);
+	// read samples: exactly the data chunk, less any truncation of the file
+	int bytesPerSample = nChannels*sizeof(short);
+	nSamples = (int) (nDataBytes/bytesPerSample);
+	samples.resize(nChannels*nSamples);
 	int nSamplesRead = fread((void *) samples.data(), bytesPerSample, nSamples, in);
 	if (verbose)
 		perror("  status");
@@ -109,7 +119,7 @@ bool Wav::Read(string filename, bool verbose) {
 	}
 	samples.resize(nChannels*nSamples);
 	if (verbose)
-		printf("  %i 16-bit stereo samples (%3.2f secs)\n", nSamples, (float) nSamples/samplingRate);
+		printf("  %i 16-bit %s samples (%3.2f secs)\n", nSamples, nChannels == 2? "stereo" : "mono", (float) nSamples/samplingRate);
 	duration = (float) nSamples/samplingRate;
 	return true;
 }
@@ -219,46 +229,100 @@ float Wav::FractionPlayed() {
 
 // display
 
+// vmin, vmax hold a min/max pyramid, level after level: level 0 has the extremes
+// of each run of WAV_BUCKET samples, each further level those of pairs from the
+// level below, down to a single entry; any width then reads at most three entries
+// per pixel, so Display costs O(w) however long the recording
+
+static const int WAV_BUCKET = 16;
+
+int WavLevelSize(int nSamples, int level) {
+	int span = WAV_BUCKET<<level;
+	return (nSamples+span-1)/span;
+}
+
+int WavLevelOffset(int nSamples, int level) {
+	int offset = 0;
+	for (int l = 0; l < level; l++)
+		offset += WavLevelSize(nSamples, l);
+	return offset;
+}
+
 WavView::WavView(int x, int y, int w, int h, Wav *wav, Channel ch) :
 	x(x), y(y), w(w), h(h), wav(wav), channel(ch), nSamples(wav->nSamples) {
-	// vmin, vmax for display when w < nSamples
-	vmin.assign(w, FLT_MAX);
-	vmax.assign(w, -FLT_MAX);
-	float xscale = (float)w/nSamples;
-	float vvvmin = FLT_MAX, vvvmax = -FLT_MAX;
-	for (int i = 0; i < nSamples; i++) {
-		int k = channel == C_Mono? i : channel == C_Left? 2*i : 2*i+1;
-		float v = (float) wav->samples[k]/32767.f;
-		if (v < vvvmin) vvvmin = v;
-		if (v > vvvmax) vvvmax = v;
-		int id = (int) (xscale*i);
-		if (v < vmin[id]) vmin[id] = v;
-		if (v > vmax[id]) vmax[id] = v;
+	int stride = channel == C_Mono? 1 : 2, first = channel == C_Right? 1 : 0;
+	for (int b = 0, n = WavLevelSize(nSamples, 0); b < n; b++) {
+		float lo = FLT_MAX, hi = -FLT_MAX;
+		for (int i = b*WAV_BUCKET; i < nSamples && i < (b+1)*WAV_BUCKET; i++) {
+			float v = (float) wav->samples[stride*i+first]/32767.f;
+			if (v < lo) lo = v;
+			if (v > hi) hi = v;
+		}
+		vmin.push_back(lo);
+		vmax.push_back(hi);
+	}
+	for (int level = 1, below = 0; WavLevelSize(nSamples, level-1) > 1; level++) {
+		int nBelow = WavLevelSize(nSamples, level-1), n = WavLevelSize(nSamples, level);
+		for (int b = 0; b < n; b++) {
+			int k0 = below+2*b, k1 = 2*b+1 < nBelow? k0+1 : k0;
+			float lo = vmin[k0] < vmin[k1]? vmin[k0] : vmin[k1], hi = vmax[k0] > vmax[k1]? vmax[k0] : vmax[k1];
+			vmin.push_back(lo);
+			vmax.push_back(hi);
+		}
+		below += nBelow;
 	}
 }
 
 void WavView::Display() {
 	int4 vp = VPi();
 	vec3 grn(0,.7f,0), cyn(0,.7f,.7f), brn(.5f, 0, 0), prp(1, 0, .5f);
-	glEnable(GL_BLEND);
+	Enable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_LINE_SMOOTH);
+	Enable(GL_LINE_SMOOTH);
 	glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
 	glViewport(x, y, w, h);
 	UseDrawShader(mat4());
-	if (w < nSamples)
+	// the whole waveform is one line strip, so one upload and one draw
+	std::vector<vec3> strip;
+	float dx = 2.f/(float)(w > 1? w-1 : 1);
+	if (w < nSamples) {
+		// per pixel, a vertical span from min to max, alternately up and down so the spans join
+		float spp = (float) nSamples/w;		// samples per pixel
+		int level = 0, stride = channel == C_Mono? 1 : 2, first = channel == C_Right? 1 : 0;
+		while ((WAV_BUCKET<<(level+1)) <= spp)
+			level++;
+		int span = WAV_BUCKET<<level, offset = WavLevelOffset(nSamples, level);
+		strip.reserve(2*w);
 		for (int i = 0; i < w; i++) {
-			float t = (float) i/(w-1), xx = 2*t-1;
-			Line(vec2(xx, vmin[i]), vec2(xx, vmax[i]), 1, grn);
-		}
-	else
-		for (int i = 1; i < nSamples; i++) {
-			int k1 = channel == C_Mono? i : channel == C_Left? 2*i : 2*i+1;
-			int k0 = channel == C_Mono? k1-1 : k1-2;
-			float x0 = (float)(i-1)/(nSamples-1), x1 = (float)i/(nSamples-1);
-			float v0 = (float)wav->samples[k0]/32767.f, v1 = (float)wav->samples[k1]/32767.f;
-			Line(vec2(2*x0-1, v0), vec2(2*x1-1, v1), 1, cyn);
+			int s0 = (int) (spp*i), s1 = (int) (spp*(i+1));
+			if (s1 > nSamples) s1 = nSamples;
+			if (s1 <= s0) s1 = s0+1;
+			float lo = FLT_MAX, hi = -FLT_MAX;
+			if (spp < WAV_BUCKET)
+				for (int k = s0; k < s1; k++) {		// fewer than WAV_BUCKET samples
+					float v = (float) wav->samples[stride*k+first]/32767.f;
+					if (v < lo) lo = v;
+					if (v > hi) hi = v;
+				}
+			else
+				for (int b = s0/span; b <= (s1-1)/span; b++) {		// at most three entries
+					if (vmin[offset+b] < lo) lo = vmin[offset+b];
+					if (vmax[offset+b] > hi) hi = vmax[offset+b];
+				}
+			float xx = -1+dx*i;
+			strip.push_back(vec3(xx, i&1? hi : lo, 0));
+			strip.push_back(vec3(xx, i&1? lo : hi, 0));
 		}
+		LineStrip((int) strip.size(), strip.data(), grn, 1, 1);
+	}
+	else {
+		int stride = channel == C_Mono? 1 : 2, first = channel == C_Right? 1 : 0;
+		strip.resize(nSamples);
+		dx = 2.f/(float)(nSamples > 1? nSamples-1 : 1);
+		for (int i = 0; i < nSamples; i++)
+			strip[i] = vec3(-1+dx*i, (float) wav->samples[stride*i+first]/32767.f, 0);
+		LineStrip(nSamples, strip.data(), cyn, 1, 1);
+	}
 	glViewport(vp[0], vp[1], vp[2], vp[3]);
 	UseDrawShader(ScreenMode());
 	Quad(x, y, x, y+h, x+w, y+h, x+w, y, false, brn, 1, 1);
@@ -3,6 +3,7 @@
 
 #include <float.h>
 #include "Draw.h"
+#include "GLState.h"
 #include "GLXtras.h"
 #include "IO.h"
 #include "Misc.h"
@@ -536,14 +537,14 @@ void Joystick::Draw(vec3 color, mat4 modelview, mat4 persp) {
 	UseDrawShader(persp*modelview);
 #ifdef GL_LINE_STIPPLE
 //	if (!frontFacing) {
-		glEnable(GL_LINE_STIPPLE);
+		Enable(GL_LINE_STIPPLE);
 		glLineStipple(6, 0xAAAA);
 //	}
 #endif
 //  ArrowV(base, len*v, modelview, color, NULL, 10);
 	Line(*base, *base+*vec, 5, color);
 #ifdef GL_LINE_STIPPLE
-	glDisable(GL_LINE_STIPPLE);
+	Disable(GL_LINE_STIPPLE);
 #endif
 	Disk(*base, 12, vec3(1,0,1));
 	Disk(*base+*vec, 12, vec3(1,0,1));
@@ -711,11 +712,11 @@ void Magnifier::Display(int2 displayLoc, bool showSrcWindow) {
 			vec3 col(pixel[0], pixel[1], pixel[2]);
 			h.Rect(displayLoc[0]+blockSize*i, displayLoc[1]+blockSize*j+dy, blockSize, blockSize, true, col);
 		}
-	bool blendOn = glIsEnabled(GL_BLEND);
-	glDisable(GL_BLEND);
+	bool blendOn = IsEnabled(GL_BLEND);
+	Disable(GL_BLEND);
 	if (showSrcWindow)
 		h.Rect(srcLoc[0], srcLoc[1], nxBlocks-1, nyBlocks-1, false, cursorColor);
 	h.Rect(displayLoc[0], displayLoc[1]+dy, nxBlocks*blockSize, nyBlocks*blockSize, false, frameColor);
-	if (blendOn) glEnable(GL_BLEND);
+	if (blendOn) Enable(GL_BLEND);
 	delete [] pixels;
 }
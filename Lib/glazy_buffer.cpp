@@ -1,4 +1,6 @@
 #include "glazy_buffer.h"
+#include "glazy_safety.h"
+#include "GLState.h"
 
 namespace glazy {
 	namespace compat {
@@ -9,39 +11,36 @@ namespace glazy {
 		// and then swapping the original back in. This is less inefficient, but it
 		// is the price that must be paid for ergonomic data movement without
 		// introducing nasty, hard-to-debug side effects.
+		// The original binding comes from the GLState shadow, not from a
+		// glGetIntegerv round trip, and rebinding the same buffer is elided.
 
 		void named_buffer_data(GLuint id, size_t size, void* data, GLenum usage) {
-			safety::entry_guard("compat::named_buffer_data()");
-			GLuint old;
-			// Why would OpenGL base all object identifiers around unsigned integers,
-			// but not provide a get routine for unsigned integers?
-			glGetIntegerv(GL_ARRAY_BUFFER_BINDING, reinterpret_cast<GLint*>(&old));
-			glBindBuffer(GL_ARRAY_BUFFER, id);
+			GLAZY_ENTRY_GUARD("compat::named_buffer_data()");
+			GLuint old = ::BoundBuffer(GL_ARRAY_BUFFER);
+			::BindBuffer(GL_ARRAY_BUFFER, id);
 			glBufferData(GL_ARRAY_BUFFER, size, data, usage);
-			glBindBuffer(GL_ARRAY_BUFFER, old);
-			safety::exit_guard("compat::named_buffer_data()");
+			::BindBuffer(GL_ARRAY_BUFFER, old);
+			GLAZY_EXIT_GUARD("compat::named_buffer_data()");
 		}
 
 		void* map_named_buffer(GLuint id, GLenum access) {
-			safety::entry_guard("compat::map_named_buffer()");
+			GLAZY_ENTRY_GUARD("compat::map_named_buffer()");
 			void* result;
-			GLuint old;
-			glGetIntegerv(GL_ARRAY_BUFFER_BINDING, reinterpret_cast<GLint*>(&old));
-			glBindBuffer(GL_ARRAY_BUFFER, id);
+			GLuint old = ::BoundBuffer(GL_ARRAY_BUFFER);
+			::BindBuffer(GL_ARRAY_BUFFER, id);
 			result = glMapBuffer(GL_ARRAY_BUFFER, access);
-			glBindBuffer(GL_ARRAY_BUFFER, old);
-			safety::exit_guard("compat::map_named_buffer()");
+			::BindBuffer(GL_ARRAY_BUFFER, old);
+			GLAZY_EXIT_GUARD("compat::map_named_buffer()");
 			return result;
 		}
 
 		void unmap_named_buffer(GLuint id) {
-			safety::entry_guard("compat::unmap_named_buffer()");
-			GLuint old;
-			glGetIntegerv(GL_ARRAY_BUFFER_BINDING, reinterpret_cast<GLint*>(&old));
-			glBindBuffer(GL_ARRAY_BUFFER, id);
+			GLAZY_ENTRY_GUARD("compat::unmap_named_buffer()");
+			GLuint old = ::BoundBuffer(GL_ARRAY_BUFFER);
+			::BindBuffer(GL_ARRAY_BUFFER, id);
 			glUnmapBuffer(GL_ARRAY_BUFFER);
-			glBindBuffer(GL_ARRAY_BUFFER, old);
-			safety::exit_guard("compat::unmap_named_buffer()");
+			::BindBuffer(GL_ARRAY_BUFFER, old);
+			GLAZY_EXIT_GUARD("compat::unmap_named_buffer()");
 		}
 
 	}
@@ -1,6 +1,12 @@
 
 
 #include "glazy_common.h"
+#include "glazy_safety.h"
+#include "GLState.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
 
 
 namespace glazy {
@@ -46,21 +52,98 @@ namespace glazy {
 			}
 		}
 
-		void entry_guard(std::string fn_name) {
-			if (true) { //flags::debug) {
-				std::string context = "Encountered OpenGL error from before '";
-				context += fn_name + "' was called.";
-				auto_throw(context);
+		namespace {
+			std::atomic<char const*> last_fn("");		// last guarded call, a string literal or interned
+			bool debug_output = false;					// errors come from debug_callback, not glGetError
+			std::atomic<bool> has_pending(false);		// debug_callback has an error for the next guard
+			std::mutex pending_mutex;
+			std::string pending;
+
+		#if GLAZY_DIAGNOSTICS
+			void APIENTRY debug_callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, GLchar const* message, void const* user) {
+				// may run on a driver thread; only the first error until the next guard is kept
+				if (type != GL_DEBUG_TYPE_ERROR || has_pending.load(std::memory_order_acquire)) {
+					return;
+				}
+				std::lock_guard<std::mutex> lock(pending_mutex);
+				pending = std::string(message) + " (reported after '" + last_fn.load() + "')";
+				has_pending.store(true, std::memory_order_release);
+			}
+		#endif
+
+			void throw_pending() {
+				std::string message;
+				{
+					std::lock_guard<std::mutex> lock(pending_mutex);
+					message.swap(pending);
+					has_pending.store(false, std::memory_order_relaxed);
+				}
+				throw std::runtime_error("OpenGL error: " + message);
 			}
 		}
 
-		void exit_guard(std::string fn_name) {
+		bool enable_debug_output() {
+		#if GLAZY_DIAGNOSTICS
+			if (glDebugMessageCallback == nullptr) {
+				return false;
+			}
+			::Enable(GL_DEBUG_OUTPUT);
+			glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+			glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+			glDebugMessageCallback(debug_callback, nullptr);
+			debug_output = true;
+			return true;
+		#else
+			return false;
+		#endif
+		}
+
+		void entry_guard(char const* fn_name) {
+			if (debug_output) {
+				if (has_pending.load(std::memory_order_acquire)) {
+					throw_pending();
+				}
+				last_fn = fn_name;
+				return;
+			}
+			std::string context = "Encountered OpenGL error from before '";
+			context += fn_name;
+			context += "' was called.";
+			auto_throw(context);
+		}
+
+		void exit_guard(char const* fn_name) {
+			if (debug_output) {
+				if (has_pending.load(std::memory_order_acquire)) {
+					throw_pending();
+				}
+				return;
+			}
 			if (flags::debug) {
 				std::string context = "Encountered OpenGL error during evaluation of '";
-				context += fn_name + "'.";
+				context += fn_name;
+				context += "'.";
 				auto_throw(context);
 			}
 		}
+
+		// The std::string overloads get temporaries, but last_fn must outlive the
+		// call (debug_callback reads it later), so their names are interned. Set
+		// nodes never move, so the pointers stay valid.
+		char const* intern(std::string const& fn_name) {
+			static std::mutex names_mutex;
+			static std::unordered_set<std::string> names;
+			std::lock_guard<std::mutex> lock(names_mutex);
+			return names.insert(fn_name).first->c_str();
+		}
+
+		void entry_guard(std::string fn_name) {
+			entry_guard(debug_output? intern(fn_name) : fn_name.c_str());
+		}
+
+		void exit_guard(std::string fn_name) {
+			exit_guard(fn_name.c_str());
+		}
 	}
 
 
@@ -97,6 +180,10 @@ namespace glazy {
 			};
 			#endif
 
+			#if GLAZY_DIAGNOSTICS
+			platform_hints.push_back({GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE});
+			#endif
+
 			for (auto&& hint : platform_hints) {
 				glfwWindowHint(hint.hint, hint.value);
 			}
@@ -119,6 +206,7 @@ namespace glazy {
 			if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
 				throw std::runtime_error("Failed to initialize OpenGL context.");
 			}
+			safety::enable_debug_output();
 			return result;
 		}
 	}
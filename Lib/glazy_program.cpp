@@ -1,6 +1,8 @@
 
 
 #include "glazy_program.h"
+#include "glazy_safety.h"
+#include "GLState.h"
 
 
 namespace glazy {
@@ -38,7 +40,7 @@ namespace glazy {
 
 
 	void GPUProgram::check_linking() {
-		safety::entry_guard("GPUProgram::check_linking");
+		GLAZY_ENTRY_GUARD("GPUProgram::check_linking");
 		GLint status;
 		glGetProgramiv(id, GL_LINK_STATUS, &status);
 		if (!status) {
@@ -52,15 +54,15 @@ namespace glazy {
 			message += "\n\"\"\"\n";
 			throw std::runtime_error(message);
 		}
-		safety::exit_guard("GPUProgram::check_linking");
+		GLAZY_EXIT_GUARD("GPUProgram::check_linking");
 	}
 
 
 
 	void GPUProgram::attach(GLuint shader_id) {
-		safety::entry_guard("GPUProgram::attach");
+		GLAZY_ENTRY_GUARD("GPUProgram::attach");
 		glAttachShader(id,shader_id);
-		safety::exit_guard("GPUProgram::attach");
+		GLAZY_EXIT_GUARD("GPUProgram::attach");
 	}
 
 	GPUProgram::GPUProgram(
@@ -70,7 +72,7 @@ namespace glazy {
 		Shader<GL_GEOMETRY_SHADER>        geometry,
 		Shader<GL_FRAGMENT_SHADER>        fragment
 	) {
-		safety::entry_guard("GPUProgram::GPUProgram(vertex,tess_cont,tess_eval,geometry,fragment)");
+		GLAZY_ENTRY_GUARD("GPUProgram::GPUProgram(vertex,tess_cont,tess_eval,geometry,fragment)");
 		if (vertex.is_empty()) {
 			throw std::runtime_error("Render pipeline must have a vertex shader.");
 		}
@@ -95,7 +97,7 @@ namespace glazy {
 		attach(fragment);
 		glLinkProgram(id);
 		check_linking();
-		safety::exit_guard("GPUProgram::GPUProgram(vertex,tess_cont,tess_eval,geometry,fragment)");
+		GLAZY_EXIT_GUARD("GPUProgram::GPUProgram(vertex,tess_cont,tess_eval,geometry,fragment)");
 	}
 
 	GPUProgram::operator GLuint() {
@@ -107,12 +109,12 @@ namespace glazy {
 	}
 
 	GPUProgram::BindGuard::BindGuard(GPUProgram& program) : program(program) {
-		safety::entry_guard("GPUProgram::BindGuard::bind");
+		GLAZY_ENTRY_GUARD("GPUProgram::BindGuard::bind");
 		if (bind_stack.empty() || (bind_stack.top() != program.id)) {
-			glUseProgram(program.id);
+			::UseProgram(program.id);
 		}
 		bind_stack.push(program.id);
-		safety::exit_guard("GPUProgram::BindGuard::bind");
+		GLAZY_EXIT_GUARD("GPUProgram::BindGuard::bind");
 	}
 
 	GPUProgram::BindGuard::~BindGuard() {
@@ -123,20 +125,20 @@ namespace glazy {
 		}
 		bind_stack.pop();
 		if ((!bind_stack.empty()) && (bind_stack.top() != program.id)) {
-			glUseProgram(bind_stack.top());
+			::UseProgram(bind_stack.top());
 		}
 	}
 
 
 	GLint GPUProgram::attribute_index (std::string name) {
-		safety::entry_guard("GPUProgram::attribute_index");
+		GLAZY_ENTRY_GUARD("GPUProgram::attribute_index");
 		GLint index = glGetAttribLocation(id, name.c_str());
 		if (index < 0) {
 			std::string message = "Attribute '";
 			message += name + "' does not exist.";
 			throw std::runtime_error(message);
 		}
-		safety::exit_guard("GPUProgram::attribute_index");
+		GLAZY_EXIT_GUARD("GPUProgram::attribute_index");
 		return index;
 	}
 
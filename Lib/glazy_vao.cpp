@@ -1,32 +1,34 @@
 
 #include "glazy_vao.h"
+#include "glazy_safety.h"
+#include "GLState.h"
 
 namespace glazy {
 
 
 
 	VAO::VAO() {
-		safety::entry_guard("VAO::VAO()");
+		GLAZY_ENTRY_GUARD("VAO::VAO()");
 		id = 0;
 		glGenVertexArrays(1, &id);
 		if (id == 0) {
 			throw std::runtime_error("Failed to allocate id for VAO.");
 		}
-		safety::exit_guard("VAO::VAO()");
+		GLAZY_EXIT_GUARD("VAO::VAO()");
 	}
 
 
 	VAO::VAO(VAO&& other)
 		: id(other.id)
 	{
-		safety::entry_guard("VAO::VAO(VAO&&)");
+		GLAZY_ENTRY_GUARD("VAO::VAO(VAO&&)");
 		other.id = 0;
-		safety::exit_guard("VAO::VAO(VAO&&)");
+		GLAZY_EXIT_GUARD("VAO::VAO(VAO&&)");
 	}
 
 	VAO::~VAO() {
 		if (glIsVertexArray(id)) {
-			glDeleteVertexArrays(1, &id);
+			::DeleteVertexArrays(1, &id);
 		}
 	}
 
@@ -35,12 +37,12 @@ namespace glazy {
 	}
 
 	VAO::BindGuard::BindGuard(VAO& vao) : vao(vao) {
-		safety::entry_guard("VAO::BindGuard::BindGuard");
+		GLAZY_ENTRY_GUARD("VAO::BindGuard::BindGuard");
 		if (bind_stack.empty() || (bind_stack.top() != vao.id)) {
-			glBindVertexArray(vao.id);
+			::BindVertexArray(vao.id);
 		}
 		bind_stack.push(vao.id);
-		safety::exit_guard("VAO::BindGuard::BindGuard");
+		GLAZY_EXIT_GUARD("VAO::BindGuard::BindGuard");
 	}
 
 	VAO::BindGuard::~BindGuard() {
@@ -51,14 +53,14 @@ namespace glazy {
 		}
 		bind_stack.pop();
 		if ((!bind_stack.empty()) && (bind_stack.top() != vao.id)) {
-			glBindVertexArray(bind_stack.top());
+			::BindVertexArray(bind_stack.top());
 		}
 	}
 
 	void VAO::bind() {
-		safety::entry_guard("VAO::bind");
-		glBindVertexArray(id);
-		safety::exit_guard("VAO::bind");
+		GLAZY_ENTRY_GUARD("VAO::bind");
+		::BindVertexArray(id);
+		GLAZY_EXIT_GUARD("VAO::bind");
 	}
 
 
@@ -69,22 +71,22 @@ namespace glazy {
 
 
 	VAO::Attribute& VAO::Attribute::enable() {
-		safety::entry_guard("AttributeAccessor::enable");
+		GLAZY_ENTRY_GUARD("AttributeAccessor::enable");
 		{
 			BindGuard bind_guard(vao);
 			glEnableVertexAttribArray(index);
 		}
-		safety::exit_guard("AttributeAccessor::enable");
+		GLAZY_EXIT_GUARD("AttributeAccessor::enable");
 		return *this;
 	}
 
 	VAO::Attribute& VAO::Attribute::disable() {
-		safety::entry_guard("AttributeAccessor::disable");
+		GLAZY_ENTRY_GUARD("AttributeAccessor::disable");
 		{
 			BindGuard bind_guard(vao);
 			glDisableVertexAttribArray(index);
 		}
-		safety::exit_guard("AttributeAccessor::disable");
+		GLAZY_EXIT_GUARD("AttributeAccessor::disable");
 		return *this;
 	}
 
@@ -115,12 +117,12 @@ namespace glazy {
 	VAO::BindGuard::BindGuard(SharedVAO& svao)
 		: vao(svao)
 	{
-		safety::entry_guard("VAO::BindGuard::BindGuard");
+		GLAZY_ENTRY_GUARD("VAO::BindGuard::BindGuard");
 		if (bind_stack.empty() || (bind_stack.top() != vao.id)) {
-			glBindVertexArray(vao.id);
+			::BindVertexArray(vao.id);
 		}
 		bind_stack.push(vao.id);
-		safety::exit_guard("VAO::BindGuard::BindGuard");
+		GLAZY_EXIT_GUARD("VAO::BindGuard::BindGuard");
 	}
 
 }
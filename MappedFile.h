@@ -0,0 +1,29 @@
+// MappedFile.h - read-only memory mapping of a whole file
+
+#ifndef MAPPEDFILE_HDR
+#define MAPPEDFILE_HDR
+
+// The file's bytes are used in place: nothing is read up front, and pages are
+// brought in by the OS as they are touched and shared with the file cache.
+
+class MappedFile {
+public:
+    MappedFile() { }
+    ~MappedFile() { close(); }
+    bool open(const char *filename);
+        // map filename; return false (and leave this closed) if it can't be opened or is empty
+    void close();
+    const unsigned char *data() const { return bytes; }
+    int size() const { return length; }
+    bool isOpen() const { return bytes != nullptr; }
+private:
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+    const unsigned char *bytes = nullptr;
+    int length = 0;
+#ifdef _WIN32
+    void *file = nullptr, *mapping = nullptr;
+#endif
+};
+
+#endif
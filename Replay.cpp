@@ -0,0 +1,160 @@
+// Replay.cpp - compact input log for GameWorld sessions, and its player
+
+#include "Replay.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+enum Op { INPUT = 1, RESET, NEXT_LEVEL, END };
+const char *magic = "BBR1";
+
+uint64_t ZigZag(int v) { return v < 0 ? ((uint64_t) -(int64_t) v << 1) - 1 : (uint64_t) v << 1; }
+
+int UnZigZag(uint64_t v) { return v & 1 ? -(int) (v >> 1) - 1 : (int) (v >> 1); }
+
+struct Reader {
+    const std::vector<unsigned char> &bytes;
+    size_t pos;
+    bool ok = true;
+    bool get(uint64_t &v) {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= bytes.size())
+                return ok = false;
+            unsigned char c = bytes[pos++];
+            v |= (uint64_t) (c & 0x7f) << shift;
+            if (!(c & 0x80))
+                return true;
+        }
+        return ok = false;
+    }
+    bool byte(unsigned char &c) {
+        if (pos >= bytes.size())
+            return ok = false;
+        c = bytes[pos++];
+        return true;
+    }
+};
+
+} // end namespace
+
+// Recording
+
+void InputRecorder::put(uint64_t v) {
+    // LEB128: seven bits per byte, high bit set on all but the last
+    for (; v >= 0x80; v >>= 7)
+        log.push_back((unsigned char) (v | 0x80));
+    log.push_back((unsigned char) v);
+}
+
+void InputRecorder::record(unsigned char op) {
+    put(ticks - lastRecord);
+    log.push_back(op);
+    lastRecord = ticks;
+}
+
+void InputRecorder::begin(uint64_t seed) {
+    log.assign(magic, magic + 4);
+    put(seed);
+    ticks = lastRecord = 0;
+    held = GameInput();
+}
+
+void InputRecorder::reset(int level, int rows, int cols) {
+    record(RESET);
+    put(level);
+    put(rows);
+    put(cols);
+}
+
+void InputRecorder::nextLevel() {
+    record(NEXT_LEVEL);
+}
+
+void InputRecorder::step(const GameInput &input) {
+    if (input.moveLeft != held.moveLeft || input.moveRight != held.moveRight || input.space || input.aim) {
+        record(INPUT);
+        unsigned char flags = (input.moveLeft ? 1 : 0) | (input.moveRight ? 2 : 0) | (input.space ? 4 : 0) | (input.aim ? 8 : 0);
+        log.push_back(flags);
+        if (input.aim)
+            put(ZigZag(input.aim));
+        held.moveLeft = input.moveLeft;
+        held.moveRight = input.moveRight;
+    }
+    ticks++;
+}
+
+void InputRecorder::end() {
+    record(END);
+}
+
+bool InputRecorder::save(const char *filename) const {
+    FILE *out = fopen(filename, "wb");
+    if (!out)
+        return false;
+    bool ok = fwrite(log.data(), 1, log.size(), out) == log.size();
+    fclose(out);
+    return ok;
+}
+
+// Playback
+
+bool ReadReplay(const char *filename, std::vector<unsigned char> &bytes) {
+    FILE *in = fopen(filename, "rb");
+    if (!in)
+        return false;
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    bytes.resize(size > 0 ? size : 0);
+    bool ok = fread(bytes.data(), 1, bytes.size(), in) == bytes.size();
+    fclose(in);
+    return ok;
+}
+
+bool PlayReplay(const std::vector<unsigned char> &bytes, GameWorld &world, long long *ticks) {
+    if (bytes.size() < 4 || memcmp(bytes.data(), magic, 4))
+        return false;
+    Reader r = { bytes, 4 };
+    uint64_t seed, delta, level, rows, cols;
+    if (!r.get(seed))
+        return false;
+    world = GameWorld();
+    world.seed(seed);
+    GameInput held;
+    long long pos = 0, next = 0;
+    unsigned char op = 0;
+    while (op != END && r.get(delta) && r.byte(op)) {
+        // hold the keys until the record's tick
+        for (next += (long long) delta; pos < next; pos++)
+            world.step(held);
+        if (op == INPUT) {
+            unsigned char flags;
+            uint64_t aim = 0;
+            if (!r.byte(flags) || ((flags & 8) && !r.get(aim)))
+                break;
+            GameInput input;
+            input.moveLeft = (flags & 1) != 0;
+            input.moveRight = (flags & 2) != 0;
+            input.space = (flags & 4) != 0;
+            input.aim = UnZigZag(aim);
+            world.step(input);
+            pos++; // deltas count from the record's tick, which has now run
+            held.moveLeft = input.moveLeft;
+            held.moveRight = input.moveRight;
+        }
+        else if (op == RESET) {
+            if (!r.get(level) || !r.get(rows) || !r.get(cols))
+                break;
+            world.reset((int) level, (int) rows, (int) cols);
+        }
+        else if (op == NEXT_LEVEL)
+            world.nextLevel();
+        else if (op != END)
+            return false;
+    }
+    if (ticks)
+        *ticks = pos;
+    return r.ok && op == END;
+}
@@ -0,0 +1,46 @@
+// Replay.h - compact input log for GameWorld sessions, and its player
+
+#ifndef REPLAY_HDR
+#define REPLAY_HDR
+
+#include <stdint.h>
+#include <vector>
+#include "GameWorld.h"
+
+// A log is the world seed plus a record for every tick whose input differs from
+// the held keys of the tick before, and for every reset or level change. Each
+// record starts with the varint count of ticks since the previous record, so an
+// idle stretch costs nothing and a typical record is two or three bytes.
+//
+// Layout: "BBR1", varint seed, then records of [varint delta][op][payload]:
+//   INPUT: flags byte (1 left, 2 right, 4 space, 8 aim follows), zigzag varint aim
+//   RESET: varint level, rows, cols
+//   NEXT_LEVEL, END: no payload
+
+class InputRecorder {
+public:
+    void begin(uint64_t seed);
+        // start a new log; call before the world's first reset
+    void reset(int level, int rows, int cols);
+    void nextLevel();
+    void step(const GameInput &input);
+        // call once per GameWorld::step, with the input passed to it
+    void end();
+        // close the log; bytes() is then a complete replay
+    const std::vector<unsigned char> &bytes() const { return log; }
+    bool save(const char *filename) const;
+private:
+    std::vector<unsigned char> log;
+    long long ticks = 0, lastRecord = 0;
+    GameInput held; // held keys as of the last INPUT record
+    void record(unsigned char op);
+    void put(uint64_t v);
+};
+
+bool ReadReplay(const char *filename, std::vector<unsigned char> &bytes);
+
+bool PlayReplay(const std::vector<unsigned char> &bytes, GameWorld &world, long long *ticks = nullptr);
+    // re-execute a log on world from scratch as fast as possible
+    // return false if the log is malformed; ticks, if given, is set to the number of steps run
+
+#endif
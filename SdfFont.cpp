@@ -0,0 +1,37 @@
+// SdfFont.cpp - signed-distance-field font atlas, baked offline and mapped at run time
+
+#include "SdfFont.h"
+#include <stdio.h>
+#include <string.h>
+
+bool SdfFont::open(const char *filename) {
+    if (!file.open(filename) || !open(file.data(), file.size(), filename)) {
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+bool SdfFont::open(const unsigned char *bytes, int size, const char *name) {
+    glyphs = nullptr;
+    atlas = nullptr;
+    const SdfFontHeader *h = (const SdfFontHeader *) bytes;
+    bool ok = size >= (int) sizeof(SdfFontHeader) && !memcmp(h->magic, "BSDF", 4) && h->version == SDF_FONT_VERSION &&
+        h->nGlyphs >= 0 && h->width > 0 && h->height > 0 &&
+        (long long) size >= (long long) sizeof(SdfFontHeader) + (long long) h->nGlyphs * (long long) sizeof(SdfGlyph) + (long long) h->width * h->height;
+    if (!ok) {
+        fprintf(stderr, "SdfFont: %s is not a version %d atlas; rebake it with FontBaker\n", name, SDF_FONT_VERSION);
+        return false;
+    }
+    base = h;
+    glyphs = (const SdfGlyph *) (bytes + sizeof(SdfFontHeader));
+    atlas = (const unsigned char *) (glyphs + h->nGlyphs);
+    return true;
+}
+
+const SdfGlyph *SdfFont::glyph(int c) const {
+    if (!glyphs)
+        return nullptr;
+    int i = c - header().firstChar;
+    return i >= 0 && i < header().nGlyphs ? &glyphs[i] : nullptr;
+}
@@ -0,0 +1,53 @@
+// SdfFont.h - signed-distance-field font atlas, baked offline and mapped at run time
+
+#ifndef SDFFONT_HDR
+#define SDFFONT_HDR
+
+#include "MappedFile.h"
+
+// Apps/FontBaker rasterizes a TrueType font once, at a high resolution, and
+// stores for each printable ASCII glyph the distance to its outline, sampled
+// at emSize pixels per em. Because the edge is recovered by thresholding the
+// interpolated distance, the one atlas draws crisp text at any size from about
+// half to several times emSize. The file is used in place, so loading it costs
+// one mapping and a texture upload, with no FreeType at run time.
+//
+// Layout (little-endian, 4-byte aligned): SdfFontHeader, nGlyphs SdfGlyph for
+// characters firstChar on, then width * height bytes of atlas, top row first.
+// A texel is 128 on the outline, rising by 127 / spread per em pixel inside.
+
+struct SdfFontHeader {
+    char magic[4]; // "BSDF"
+    int version;
+    int emSize; // atlas pixels per em
+    int spread; // distance range, in atlas pixels, either side of the outline
+    int width, height; // atlas size
+    float ascender, descender, lineHeight; // in atlas pixels
+    int firstChar, nGlyphs;
+};
+
+struct SdfGlyph {
+    int x, y, w, h; // atlas rect, including the spread margin; empty for a space
+    float left, top; // rect corner relative to the pen position, top is up, in atlas pixels
+    float advance;
+};
+
+const int SDF_FONT_VERSION = 1;
+
+class SdfFont {
+public:
+    bool open(const char *filename);
+        // map a baked atlas; return false if missing, truncated or of another version
+    bool open(const unsigned char *bytes, int size, const char *name = "font");
+        // use an atlas already in memory (an AssetPack entry), which must outlive this
+    const SdfFontHeader &header() const { return *base; }
+    const SdfGlyph *glyph(int c) const; // null if c is not in the atlas
+    const unsigned char *pixels() const { return atlas; }
+private:
+    MappedFile file;
+    const SdfFontHeader *base = nullptr;
+    const SdfGlyph *glyphs = nullptr;
+    const unsigned char *atlas = nullptr;
+};
+
+#endif
@@ -0,0 +1,41 @@
+// SpscQueue.h - fixed-size wait-free queue for one producer thread and one consumer thread
+
+#ifndef SPSCQUEUE_HDR
+#define SPSCQUEUE_HDR
+
+#include <atomic>
+
+// A ring of N slots indexed by two free-running counters: only the producer
+// writes head and only the consumer writes tail, so push and pop are a load,
+// a copy and a store, with no locks, retries or allocation. The counters sit
+// on separate cache lines so the two threads don't contend for one line.
+
+template <class T, int N>
+class SpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+public:
+    bool push(const T &item) {
+        // producer only; return false, dropping item, if the queue is full
+        unsigned int h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == (unsigned int) N)
+            return false;
+        items[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    bool pop(T &item) {
+        // consumer only; return false if the queue is empty
+        unsigned int t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t)
+            return false;
+        item = items[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+private:
+    alignas(64) std::atomic<unsigned int> head{0}; // items pushed
+    alignas(64) std::atomic<unsigned int> tail{0}; // items popped
+    T items[N];
+};
+
+#endif
@@ -0,0 +1,70 @@
+// Sweep.cpp - continuous collision of a moving circle against an axis-aligned box
+
+#include "Sweep.h"
+#include <cmath>
+#include <algorithm>
+
+// The set of centers touching the box is the box grown by radius with rounded
+// corners: four outward-shifted faces plus a circle at each corner. The first
+// contact is the earliest entry into any of those pieces.
+
+namespace {
+
+void Face(float p, float d, float plane, float q, float dq, float lo, float hi, float nx, float ny, SweepHit &best) {
+    // entry through a face at coordinate plane along the moving axis, clipped to [lo, hi] on the other
+    if (d == 0)
+        return;
+    float t = (plane - p) / d;
+    if (t < 0 || t > best.t)
+        return;
+    float q_t = q + dq * t;
+    if (q_t >= lo && q_t <= hi && d * (nx + ny) < 0)
+        best = { t, nx, ny };
+}
+
+void Corner(float px, float py, float dx, float dy, float radius, float cx, float cy, SweepHit &best) {
+    // smallest t >= 0 with |p + d t - c| = radius
+    float ox = px - cx, oy = py - cy;
+    float a = dx * dx + dy * dy, b = ox * dx + oy * dy, c = ox * ox + oy * oy - radius * radius;
+    if (a == 0 || b >= 0)
+        return; // not moving toward the corner
+    float disc = b * b - a * c;
+    if (disc < 0)
+        return;
+    float t = (-b - sqrt(disc)) / a;
+    if (t < 0 || t > best.t)
+        return;
+    best = { t, (ox + dx * t) / radius, (oy + dy * t) / radius };
+}
+
+} // end namespace
+
+bool sweepCircleBox(float px, float py, float dx, float dy, float radius,
+                    float x0, float y0, float x1, float y1, SweepHit &hit) {
+    // already overlapping: push out through the face the center is relatively closest to
+    float nearX = std::max(x0, std::min(px, x1)), nearY = std::max(y0, std::min(py, y1));
+    float ox = px - nearX, oy = py - nearY;
+    if (ox * ox + oy * oy < radius * radius) {
+        float hitX = (px - (x0 + x1) / 2) / (x1 - x0), hitY = (py - (y0 + y1) / 2) / (y1 - y0);
+        float nx = 0, ny = 0;
+        if (fabs(hitX) > fabs(hitY)) nx = hitX < 0 ? -1.0f : 1.0f;
+        else ny = hitY < 0 ? -1.0f : 1.0f;
+        if (dx * nx + dy * ny >= 0)
+            return false; // moving out already
+        hit = { 0, nx, ny };
+        return true;
+    }
+    SweepHit best = { 1, 0, 0 }; // a zero normal marks no contact yet
+    Face(px, dx, x0 - radius, py, dy, y0, y1, -1, 0, best);
+    Face(px, dx, x1 + radius, py, dy, y0, y1, 1, 0, best);
+    Face(py, dy, y0 - radius, px, dx, x0, x1, 0, -1, best);
+    Face(py, dy, y1 + radius, px, dx, x0, x1, 0, 1, best);
+    Corner(px, py, dx, dy, radius, x0, y0, best);
+    Corner(px, py, dx, dy, radius, x1, y0, best);
+    Corner(px, py, dx, dy, radius, x0, y1, best);
+    Corner(px, py, dx, dy, radius, x1, y1, best);
+    if (best.nx == 0 && best.ny == 0)
+        return false;
+    hit = best;
+    return true;
+}
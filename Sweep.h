@@ -0,0 +1,17 @@
+// Sweep.h - continuous collision of a moving circle against an axis-aligned box
+
+#ifndef SWEEP_HDR
+#define SWEEP_HDR
+
+struct SweepHit {
+    float t; // fraction of the move at first contact, in [0, 1]
+    float nx, ny; // unit surface normal at contact, pointing out of the box
+};
+
+bool sweepCircleBox(float px, float py, float dx, float dy, float radius,
+                    float x0, float y0, float x1, float y1, SweepHit &hit);
+    // circle of radius at (px, py) moving by (dx, dy) against box [x0,x1]x[y0,y1]
+    // return true if it makes contact while moving into the box, setting hit to the earliest contact
+    // a circle that already overlaps the box reports t = 0 with the normal of the nearest face
+
+#endif
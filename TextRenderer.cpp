@@ -0,0 +1,228 @@
+// TextRenderer.cpp - batched text from one signed-distance-field atlas, with cached string meshes
+
+#include <glad.h>
+#include <GLFW/glfw3.h>
+#include "FrameUniforms.h"
+#include "GLState.h"
+#include "GLXtras.h"
+#include "TextRenderer.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <algorithm>
+
+namespace {
+
+const int EVICT_PERIOD = 64, EVICT_AGE = 120; // frames
+
+const char *vertexShader = R"(
+    #version 330
+    // one instance per string, each drawing as many vertices as the longest
+    layout (location = 0) in vec2 origin;
+    layout (location = 1) in float scale; // screen pixels per atlas pixel
+    layout (location = 2) in vec3 color;
+    layout (location = 3) in ivec2 range; // first and count of the string's vertices
+    layout (std140) uniform Frame { vec2 screen; }; // FrameUniforms, updated once per frame
+    uniform samplerBuffer points; // x, y relative to the string origin (atlas pixels, y down), u, v
+    out vec2 uv;
+    flat out vec3 vColor;
+    void main() {
+        if (gl_VertexID >= range.y) {
+            gl_Position = vec4(2, 2, 2, 1); // past the string's end: whole triangles, outside the view
+            return;
+        }
+        vec4 point = texelFetch(points, range.x + gl_VertexID);
+        vec2 p = origin + scale * point.xy;
+        gl_Position = vec4(2 * p.x / screen.x - 1, 1 - 2 * p.y / screen.y, 0, 1);
+        uv = point.zw;
+        vColor = color;
+    }
+)";
+
+const char *pixelShader = R"(
+    #version 330
+    in vec2 uv;
+    flat in vec3 vColor;
+    out vec4 pColor;
+    uniform sampler2D glyphs;
+    void main() {
+        // the outline is at .5; blend across about one screen pixel, whatever the scale
+        float d = texture(glyphs, uv).r, w = .7 * fwidth(d);
+        pColor = vec4(vColor, smoothstep(.5 - w, .5 + w, d));
+    }
+)";
+
+} // end namespace
+
+bool TextRenderer::init(const char *atlasFile) {
+    if (!font.open(atlasFile)) {
+        printf("TextRenderer: can't load %s\n", atlasFile);
+        return false;
+    }
+    return create();
+}
+
+bool TextRenderer::init(const unsigned char *atlas, int size) {
+    return font.open(atlas, size) && create();
+}
+
+bool TextRenderer::create() {
+    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress) || !GLAD_GL_VERSION_3_3) {
+        printf("TextRenderer: OpenGL 3.3 unavailable\n");
+        return false;
+    }
+    const SdfFontHeader &h = font.header();
+    glGenTextures(1, &texture);
+    BindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, h.width, h.height, 0, GL_RED, GL_UNSIGNED_BYTE, font.pixels());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    BindTexture(GL_TEXTURE_2D, 0);
+    program = LinkProgramViaCode(&vertexShader, &pixelShader);
+    if (!program)
+        return false;
+    FrameUniforms::attach(program);
+    UseProgram(program);
+    SetUniform(program, "glyphs", 0); // texture units, fixed for the program's life
+    SetUniform(program, "points", 1);
+    glGenBuffers(1, &vertexBuffer);
+    BindBuffer(GL_ARRAY_BUFFER, vertexBuffer); // creates it, so glTexBuffer can refer to it
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+    glGenTextures(1, &pointTexture);
+    BindTexture(GL_TEXTURE_BUFFER, pointTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, vertexBuffer); // follows the buffer's storage as it grows
+    BindTexture(GL_TEXTURE_BUFFER, 0);
+    glGenVertexArrays(1, &vao);
+    BindVertexArray(vao);
+    glGenBuffers(1, &stringBuffer);
+    BindBuffer(GL_ARRAY_BUFFER, stringBuffer);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Queued), (void *) offsetof(Queued, x));
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(Queued), (void *) offsetof(Queued, scale));
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Queued), (void *) offsetof(Queued, r));
+    glVertexAttribIPointer(3, 2, GL_INT, sizeof(Queued), (void *) offsetof(Queued, first));
+    for (int i = 0; i < 4; i++) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 1);
+    }
+    BindVertexArray(0);
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+    UseProgram(0);
+    return true;
+}
+
+float TextRenderer::width(const std::string &text, float size) const {
+    float w = 0;
+    for (unsigned char c : text)
+        if (const SdfGlyph *g = font.glyph(c))
+            w += g->advance;
+    return ready() ? w * size / font.header().emSize : 0;
+}
+
+const TextRenderer::Mesh &TextRenderer::mesh(const std::string &text) {
+    auto it = cache.find(text);
+    if (it != cache.end()) {
+        it->second.lastUsed = frame;
+        return it->second;
+    }
+    // two triangles per visible glyph, in atlas pixels from the start of the baseline
+    const SdfFontHeader &h = font.header();
+    float du = 1.f / h.width, dv = 1.f / h.height;
+    Mesh m = { (int) vertices.size() / 4, 0, frame };
+    float pen = 0;
+    for (unsigned char c : text) {
+        const SdfGlyph *g = font.glyph(c);
+        if (!g)
+            continue;
+        if (g->w > 0) {
+            float x0 = pen + g->left, y0 = -g->top, x1 = x0 + g->w, y1 = y0 + g->h;
+            float u0 = g->x * du, v0 = g->y * dv, u1 = (g->x + g->w) * du, v1 = (g->y + g->h) * dv;
+            float quad[6][4] = { { x0, y0, u0, v0 }, { x1, y0, u1, v0 }, { x1, y1, u1, v1 },
+                                 { x0, y0, u0, v0 }, { x1, y1, u1, v1 }, { x0, y1, u0, v1 } };
+            vertices.insert(vertices.end(), &quad[0][0], &quad[0][0] + 24);
+            m.count += 6;
+        }
+        pen += g->advance;
+    }
+    return cache[text] = m;
+}
+
+void TextRenderer::add(const std::string &text, float x, float y, float size, const float color[3]) {
+    if (!program)
+        return;
+    const Mesh &m = mesh(text);
+    if (m.count) {
+        queue.push_back({ x, y, size / font.header().emSize, color[0], color[1], color[2], m.first, m.count });
+        maxCount = std::max(maxCount, m.count);
+    }
+}
+
+void TextRenderer::compact() {
+    // repack live strings at the front of the buffer
+    std::vector<float> live;
+    live.reserve(vertices.size() - dead);
+    for (auto &entry : cache) {
+        Mesh &m = entry.second;
+        live.insert(live.end(), vertices.begin() + 4 * m.first, vertices.begin() + 4 * (m.first + m.count));
+        m.first = (int) live.size() / 4 - m.count;
+    }
+    vertices.swap(live);
+    dead = 0;
+    uploaded = 0;
+}
+
+void TextRenderer::draw() {
+    if (!program)
+        return;
+    BindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    int size = (int) vertices.size();
+    if (size > capacity) {
+        capacity = 2 * size;
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+        uploaded = 0;
+    }
+    if (uploaded < size) // only strings new since the last frame
+        glBufferSubData(GL_ARRAY_BUFFER, uploaded * sizeof(float), (size - uploaded) * sizeof(float), &vertices[uploaded]);
+    uploaded = size;
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!queue.empty()) {
+        BindBuffer(GL_ARRAY_BUFFER, stringBuffer);
+        if ((int) queue.size() > queueCapacity) {
+            queueCapacity = 2 * (int) queue.size();
+            glBufferData(GL_ARRAY_BUFFER, queueCapacity * sizeof(Queued), NULL, GL_STREAM_DRAW);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, 0, queue.size() * sizeof(Queued), queue.data());
+        BindBuffer(GL_ARRAY_BUFFER, 0);
+        UseProgram(program);
+        ActiveTexture(GL_TEXTURE1);
+        BindTexture(GL_TEXTURE_BUFFER, pointTexture);
+        ActiveTexture(GL_TEXTURE0);
+        BindTexture(GL_TEXTURE_2D, texture);
+        Enable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        // glyph quads overlap their neighbours' margins, so depth testing would clip them
+        bool depthTest = IsEnabled(GL_DEPTH_TEST);
+        Disable(GL_DEPTH_TEST);
+        BindVertexArray(vao);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, maxCount, (GLsizei) queue.size());
+        BindVertexArray(0);
+        if (depthTest)
+            Enable(GL_DEPTH_TEST);
+        Disable(GL_BLEND);
+        BindTexture(GL_TEXTURE_2D, 0);
+        UseProgram(0);
+        queue.clear();
+        maxCount = 0;
+    }
+    if (++frame % EVICT_PERIOD == 0) {
+        for (auto it = cache.begin(); it != cache.end(); )
+            if (frame - it->second.lastUsed > EVICT_AGE) {
+                dead += 4 * it->second.count;
+                it = cache.erase(it);
+            }
+            else
+                it++;
+        if (dead > (int) vertices.size() / 2)
+            compact();
+    }
+}
@@ -0,0 +1,56 @@
+// TextRenderer.h - batched text from one signed-distance-field atlas, with cached string meshes
+
+#ifndef TEXTRENDERER_HDR
+#define TEXTRENDERER_HDR
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SdfFont.h"
+
+// Glyphs come from an SdfFont atlas baked offline by Apps/FontBaker, which is
+// mapped and uploaded as is; one atlas serves every text size. A string's quads
+// are built once, in atlas pixels relative to its origin, and kept in a vertex
+// buffer; drawing it again at any position or size reuses them, so a static
+// label costs no vertex work after its first frame and a changing one (the
+// score) only builds its new text. Strings unused for a while are evicted.
+// All queued text is one instanced draw: each string is an instance whose
+// origin, scale, color and vertex range are per-instance attributes, and the
+// vertex shader fetches the string's vertices from the vertex buffer through a
+// texture buffer, so a frame uploads only one small record per string.
+// Needs OpenGL 3.3.
+
+class TextRenderer {
+public:
+    bool init(const char *atlasFile);
+        // call once with a current GL context; return false if GL 3.3 or the atlas is unavailable
+    bool init(const unsigned char *atlas, int size);
+        // as above, from an SdfFont already in memory (an AssetPack entry), which must outlive this
+    bool ready() const { return program != 0; }
+    void add(const std::string &text, float x, float y, float size, const float color[3]);
+        // queue text size pixels per em with its baseline starting at (x, y), in pixels with y down
+    void draw();
+        // draw queued text in one call at the FrameUniforms screen size, empty the queue and evict stale strings;
+        // draws without depth testing (restoring it after); leaves no program or vertex array bound
+    float width(const std::string &text, float size) const;
+private:
+    struct Mesh { int first, count, lastUsed; };
+    struct Queued { float x, y, scale, r, g, b; int first, count; }; // one instance
+    SdfFont font;
+    std::unordered_map<std::string, Mesh> cache;
+    std::vector<float> vertices; // CPU copy of the vertex buffer: x, y, u, v per vertex
+    std::vector<Queued> queue;
+    int queueCapacity = 0; // instances the string buffer holds
+    int maxCount = 0; // vertices in the longest queued string
+    int uploaded = 0; // floats of vertices already in the vertex buffer
+    int capacity = 0; // floats the vertex buffer holds
+    int dead = 0; // floats belonging to evicted strings
+    int frame = 0;
+    unsigned int program = 0, vao = 0, vertexBuffer = 0, stringBuffer = 0, texture = 0;
+    unsigned int pointTexture = 0; // vertexBuffer as a texture buffer
+    bool create();
+    const Mesh &mesh(const std::string &text);
+    void compact();
+};
+
+#endif
@@ -0,0 +1,22 @@
+// Timers.cpp - min-heap of scheduled events on an integer tick clock
+
+#include "Timers.h"
+
+int TimerQueue::schedule(long long due, int event) {
+    int handle = nextHandle++;
+    if (nextHandle <= 0)
+        nextHandle = 1;
+    heap.push_back({ due, handle, event });
+    std::push_heap(heap.begin(), heap.end(), Later);
+    return handle;
+}
+
+void TimerQueue::cancel(int handle) {
+    for (size_t i = 0; i < heap.size(); i++)
+        if (heap[i].handle == handle) {
+            heap[i] = heap.back();
+            heap.pop_back();
+            std::make_heap(heap.begin(), heap.end(), Later);
+            return;
+        }
+}
@@ -0,0 +1,37 @@
+// Timers.h - min-heap of scheduled events on an integer tick clock
+
+#ifndef TIMERS_HDR
+#define TIMERS_HDR
+
+#include <vector>
+#include <algorithm>
+
+// Events are plain ints rather than closures, so a queue stays valid when its
+// owner is copied or moved. The clock is whatever the owner passes to advance
+// (GameWorld passes its tick count), so time stops whenever the owner stops stepping.
+
+class TimerQueue {
+public:
+    int schedule(long long due, int event);
+        // return a handle (never 0) for cancel
+    void cancel(int handle);
+        // no effect if the timer already fired or handle is 0
+    void clear() { heap.clear(); }
+    long long nextDue() const { return heap.empty() ? -1 : heap.front().due; }
+    template <class Fire> void advance(long long now, Fire fire) {
+        // call fire(event) for each timer due at or before now, earliest first (ties in schedule order)
+        while (!heap.empty() && heap.front().due <= now) {
+            std::pop_heap(heap.begin(), heap.end(), Later);
+            int event = heap.back().event;
+            heap.pop_back();
+            fire(event);
+        }
+    }
+private:
+    struct Entry { long long due; int handle, event; };
+    static bool Later(const Entry &a, const Entry &b) { return a.due != b.due ? a.due > b.due : a.handle > b.handle; }
+    std::vector<Entry> heap;
+    int nextHandle = 1;
+};
+
+#endif
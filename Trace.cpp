@@ -0,0 +1,92 @@
+// Trace.cpp - scoped timing zones, exported as Chrome trace_event JSON
+
+#include "Trace.h"
+
+#ifdef TRACE_ZONES
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char *name;
+    long long begin, end; // nanoseconds since the trace epoch
+};
+
+// Single writer (the owning thread); head counts events ever written, so the
+// live window is [head - TRACE_CAPACITY, head) and a reader can tell which
+// slots the writer may have reused while it was copying them.
+struct Ring {
+    Event events[TRACE_CAPACITY];
+    std::atomic<unsigned> head{0};
+    int tid;
+};
+
+std::mutex ringsMutex; // guards rings, taken once per thread and by dumps
+std::vector<Ring *> rings; // never freed, so a dump sees threads that have exited
+thread_local Ring *ring = nullptr;
+
+std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+long long Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+Ring *ThreadRing() {
+    if (!ring) {
+        ring = new Ring;
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        ring->tid = (int) rings.size() + 1;
+        rings.push_back(ring);
+    }
+    return ring;
+}
+
+} // end namespace
+
+TraceZone::TraceZone(const char *name) : name(name), begin(Now()) { }
+
+TraceZone::~TraceZone() {
+    Ring *r = ThreadRing();
+    unsigned h = r->head.load(std::memory_order_relaxed);
+    r->events[h & (TRACE_CAPACITY - 1)] = { name, begin, Now() };
+    r->head.store(h + 1, std::memory_order_release);
+}
+
+bool TraceDump(const char *filename) {
+    FILE *out = fopen(filename, "w");
+    if (!out)
+        return false;
+    fprintf(out, "{\"traceEvents\":[\n");
+    bool first = true;
+    std::vector<Event> copy;
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    for (Ring *r : rings) {
+        unsigned head = r->head.load(std::memory_order_acquire);
+        unsigned start = head > (unsigned) TRACE_CAPACITY ? head - TRACE_CAPACITY : 0;
+        copy.clear();
+        for (unsigned i = start; i < head; i++)
+            copy.push_back(r->events[i & (TRACE_CAPACITY - 1)]);
+        // drop whatever the writer overwrote during the copy
+        unsigned after = r->head.load(std::memory_order_acquire);
+        unsigned skip = after - start > (unsigned) TRACE_CAPACITY ? after - start - TRACE_CAPACITY : 0;
+        for (size_t i = skip; i < copy.size(); i++) {
+            const Event &e = copy[i];
+            fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    first ? "" : ",\n", e.name, r->tid, e.begin / 1000., (e.end - e.begin) / 1000.);
+            first = false;
+        }
+    }
+    fprintf(out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    return fclose(out) == 0;
+}
+
+#else
+
+bool TraceDump(const char *) { return false; }
+
+#endif
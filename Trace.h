@@ -0,0 +1,40 @@
+// Trace.h - scoped timing zones, exported as Chrome trace_event JSON
+
+#ifndef TRACE_HDR
+#define TRACE_HDR
+
+// Zones are built in only when TRACE_ZONES is defined; otherwise TRACE_ZONE
+// expands to nothing and TraceDump reports failure. Each thread records into
+// its own ring of the most recent TRACE_CAPACITY zones, so recording takes no
+// lock; a dump may run on any thread while others keep recording.
+// Load the JSON in chrome://tracing or ui.perfetto.dev.
+// game.vcxproj defines TRACE_ZONES in its Debug configurations.
+
+#ifdef TRACE_ZONES
+
+const int TRACE_CAPACITY = 1 << 16; // zones kept per thread, a power of 2
+
+class TraceZone {
+public:
+    TraceZone(const char *name);
+        // name must outlive the trace (a string literal)
+    ~TraceZone();
+private:
+    const char *name;
+    long long begin;
+};
+
+#define TRACE_CAT2(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT2(a, b)
+#define TRACE_ZONE(name) TraceZone TRACE_CAT(traceZone, __LINE__)(name)
+
+#else
+
+#define TRACE_ZONE(name)
+
+#endif
+
+bool TraceDump(const char *filename);
+    // write every thread's recorded zones to filename; return false if tracing is compiled out or on write failure
+
+#endif
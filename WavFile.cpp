@@ -0,0 +1,94 @@
+// WavFile.cpp - uncompressed 16-bit .wav located by its RIFF chunks, then mapped or streamed
+
+#include "WavFile.h"
+#include <string.h>
+#include <algorithm>
+
+namespace {
+
+unsigned int Get(const unsigned char *b, int bytes) {
+    unsigned int v = 0;
+    for (int i = bytes - 1; i >= 0; i--)
+        v = v << 8 | b[i];
+    return v;
+}
+
+} // end namespace
+
+bool WavFile::readAt(long offset, void *bytes, int n) {
+    if (mode == MAPPED) {
+        if (offset < 0 || offset + n > map.size())
+            return false;
+        memcpy(bytes, map.data() + offset, n);
+        return true;
+    }
+    return fseek(file, offset, SEEK_SET) == 0 && fread(bytes, n, 1, file) == 1;
+}
+
+bool WavFile::open(const char *filename, Mode m) {
+    close();
+    mode = m;
+    long length = 0;
+    if (mode == MAPPED) {
+        if (!map.open(filename))
+            return false;
+        length = map.size();
+    }
+    else {
+        if (!(file = fopen(filename, "rb")))
+            return false;
+        setvbuf(file, NULL, _IOFBF, 4 * STREAM_FRAMES);
+        fseek(file, 0, SEEK_END);
+        length = ftell(file);
+    }
+    unsigned char riff[12], chunk[8], fmt[16];
+    int format = 0, bits = 0;
+    long dataBytes = -1;
+    if (readAt(0, riff, 12) && !memcmp(riff, "RIFF", 4) && !memcmp(riff + 8, "WAVE", 4))
+        for (long offset = 12; dataBytes < 0 && readAt(offset, chunk, 8); ) {
+            long size = (long) std::min<unsigned long>(Get(chunk + 4, 4), length - offset - 8);
+            if (!memcmp(chunk, "fmt ", 4) && size >= 16 && readAt(offset + 8, fmt, 16)) {
+                format = Get(fmt, 2);
+                channels = Get(fmt + 2, 2);
+                rate = Get(fmt + 4, 4);
+                bits = Get(fmt + 14, 2);
+            }
+            if (!memcmp(chunk, "data", 4)) {
+                dataOffset = offset + 8;
+                dataBytes = size;
+            }
+            offset += 8 + size + (size & 1); // chunks are padded to even length
+        }
+    if (dataBytes < 0 || format != 1 || bits != 16 || channels < 1 || channels > 2 || rate <= 0 || (dataOffset & 1)) {
+        close();
+        return false;
+    }
+    frames = (int) (dataBytes / (2 * channels));
+    rewind();
+    return true;
+}
+
+int WavFile::read(short *out, int maxFrames) {
+    // the file stays positioned at frame position, so this is only a buffered read
+    int n = std::min(maxFrames, frames - position);
+    if (n <= 0)
+        return 0;
+    n = (int) fread(out, 2 * channels, n, file);
+    position += n;
+    return n;
+}
+
+void WavFile::rewind() {
+    position = 0;
+    if (file)
+        fseek(file, dataOffset, SEEK_SET);
+}
+
+void WavFile::close() {
+    map.close();
+    if (file)
+        fclose(file);
+    file = nullptr;
+    rate = channels = frames = 0;
+    dataOffset = 0;
+}
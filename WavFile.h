@@ -0,0 +1,40 @@
+// WavFile.h - uncompressed 16-bit .wav located by its RIFF chunks, then mapped or streamed
+
+#ifndef WAVFILE_HDR
+#define WAVFILE_HDR
+
+#include <stdio.h>
+#include "MappedFile.h"
+
+// open walks the chunk headers (skipping LIST, fact and the like, wherever
+// they are) to find fmt and the exact extent of data, reading nothing else.
+// A MAPPED file then plays straight from the mapping: opening costs the same
+// for any length, and only pages being played are resident, shared with the
+// file cache. A STREAMED file is read through a buffer of STREAM_FRAMES, for
+// long tracks where even an address range the size of the file is too much.
+
+class WavFile {
+public:
+    enum Mode { MAPPED, STREAMED };
+    enum { STREAM_FRAMES = 4096 };
+    ~WavFile() { close(); }
+    bool open(const char *filename, Mode mode = MAPPED);
+        // return false (and leave this closed) if filename isn't uncompressed 16-bit mono or stereo
+    void close();
+    int rate = 0, channels = 0, frames = 0; // valid once open
+    const short *samples() const { return (const short *) (map.data() + dataOffset); }
+        // MAPPED: all frames, interleaved (the file's little-endian samples, used as is)
+    int read(short *out, int maxFrames);
+        // STREAMED: copy up to maxFrames of the next frames to out; return the number copied, 0 at the end
+    void rewind();
+        // STREAMED: back to the first frame
+private:
+    Mode mode = MAPPED;
+    MappedFile map;
+    FILE *file = nullptr;
+    long dataOffset = 0;
+    int position = 0; // STREAMED: next frame to read
+    bool readAt(long offset, void *bytes, int n);
+};
+
+#endif
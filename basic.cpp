@@ -2,633 +2,229 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
-#include <ctime>
-#include <algorithm>
 #include <string>
+#include <ctime>
 #include "GLUT/glut.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-const float M_PI = 3.1415926f;
-const int SCREEN_WIDTH = 800, SCREEN_HEIGHT = 600;
-const int BRICK_ROWS = 5, BRICK_COLS = 10;
-const int BRICK_WIDTH = 58, BRICK_HEIGHT = 20;
-const int BRICK_SPACING = 2;
-const int PADDLE_WIDTH = 100, PADDLE_HEIGHT = 20;
-const int BALL_RADIUS = 10;
-const int FIREBALL_DURATION = 5; // Duration of fireball state in seconds
-const float BALL_SPEED_L1 = 0.4f; // Ball speed for level 1
-const float BALL_SPEED_L2 = 0.5f; // Ball speed for level 2
-const float BALL_SPEED_L3 = 0.6f; // Ball speed for level 3
-const float PADDLE_SPEED = 0.4f; // Paddle Speed
-const float BULLET_SPEED = 0.5f; // Speed for bullets
-const int SHRINK_DURATION = 5; // Duration of the shrink state in seconds
-const float SHRINK_FACTOR = 0.5f; // Paddle Shrink
-int bricksBroken = 0; // Track the number of bricks broken
-int lives = 1; // Initialize lives
-bool resetAfterLifeLost = false; // Flag to reset the ball after losing a life
-
-
-GLuint brickTexture1, brickTexture2, brickTexture3;
-GLuint fireballTexture;
-
-enum GameState { MENU, AIM, GAME, GAME_OVER, WIN, LEVEL_SELECT, LEVEL_COMPLETE, EXIT, INSTRUCTIONS, POWER_UPS };
+#include "AssetPack.h"
+#include "Assets.h"
+#include "Atlas.h"
+#include "AudioMixer.h"
+#include "AudioSink.h"
+#include "BrickRenderer.h"
+#include "CircleRenderer.h"
+#include "FrameUniforms.h"
+#include "GameWorld.h"
+#include "GLState.h"
+#include "ImageLoader.h"
+#include "Replay.h"
+#include "TextRenderer.h"
+#include "Trace.h"
 
 GameState currentGameState = MENU;
 int menuSelection = 0;
-float aimAngle = M_PI / 6; // Initial aim angle
-const float minAimAngle = M_PI / 6; // 30 degrees
-const float maxAimAngle = 5 * M_PI / 6; // 150 degrees
-
-enum PowerUpType { FIREBALL = 1, GUN, FLIP, SHRINK };
-
-struct Brick {
-    float x, y, width, height;
-    int type;
-    int hitsRemaining;
-    bool isVisible;
-    bool hasPowerUp;
-    PowerUpType powerUpType; // Type power-up
-    bool isBomb;
-    Brick(float x, float y, float w, float h, int t, bool powerUp = false, PowerUpType pType = FIREBALL, bool bomb = false)
-        : x(x), y(y), width(w), height(h), type(t), isVisible(true), hasPowerUp(powerUp), powerUpType(pType), isBomb(bomb) {
-        switch (type) {
-        case 1: hitsRemaining = 1; break; // 1hit
-        case 2: hitsRemaining = 2; break; // 2hit
-        case 3: hitsRemaining = 3; break; // 3hit
-        }
-    }
-};
-
-struct PowerUp {
-    float x, y; // Position power-up
-    float dx, dy; // Velocity power-up
-    bool active; // State power-up
-    float radius; // Radius power-up
-    PowerUpType type; // powerup type
-    PowerUp(float _x, float _y, float _dx, float _dy, PowerUpType _type) : x(_x), y(_y), dx(_dx), dy(_dy), active(true), radius(10.0f), type(_type) {}
-};
-
-struct Bullet {
-    float x, y, dy;
-    bool active;
-    Bullet(float _x, float _y) : x(_x), y(_y), dy(-BULLET_SPEED), active(true) {}
-};
-
-struct Ball {
-    float x, y, dx, dy, radius;
-    bool idle;
-    bool isFireball;
-    bool hasGun;
-    int gunAmmo;
-    time_t powerUpStartTime;
-    Ball() : x(SCREEN_WIDTH / 2), y(SCREEN_HEIGHT - 50), dx(0.4f), dy(-0.4f), radius(BALL_RADIUS), idle(true), isFireball(false), hasGun(false), gunAmmo(0), powerUpStartTime(0) {
-        normalizeVelocity();
-    }
-
-    void normalizeVelocity() {
-        float length = sqrt(dx * dx + dy * dy);
-        dx = (dx / length) * BALL_SPEED_L2;
-        dy = (dy / length) * BALL_SPEED_L2;
-    }
-
-    void setSpeed(float speed) {
-        float length = sqrt(dx * dx + dy * dy);
-        dx = (dx / length) * speed;
-        dy = (dy / length) * speed;
-    }
-
-    void applyPowerUp(float multiplier) {
-        dx *= multiplier;
-        dy *= multiplier;
-    }
 
-    void resetPowerUp() {
-        isFireball = false;
-        hasGun = false;
-        gunAmmo = 0;
-        normalizeVelocity();
-    }
-};
-
-struct Paddle {
-    float x, y, width, height;
-    bool moveLeft, moveRight, controlsFlipped, isShrunk;
-    time_t shrinkStartTime;
-    Paddle() : x(SCREEN_WIDTH / 2 - PADDLE_WIDTH / 2), y(SCREEN_HEIGHT - 30), width(PADDLE_WIDTH), height(PADDLE_HEIGHT), moveLeft(false), moveRight(false), controlsFlipped(false), isShrunk(false), shrinkStartTime(0) {}
-};
-
-std::vector<Brick> bricks;
-std::vector<PowerUp> powerUps; //To store power-ups
-std::vector<Bullet> bullets; // To store bullets
-Ball ball;
-Paddle paddle;
-int score = 0; // Initialize score variable
-int level = 1; // Current game level
-
-GLuint bombTexture;
-
-void loadBombTexture() {
-    int width, height, channels;
-    unsigned char* data = stbi_load("Image/bomb.png", &width, &height, &channels, 0);
-    if (data) {
-        glGenTextures(1, &bombTexture);
-        glBindTexture(GL_TEXTURE_2D, bombTexture);
-        if (channels == 3) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+GameWorld world; // Simulation state; this file only renders it and feeds it input
+GameInput input; // Input gathered by key_callback for the next world step
+BrickRenderer brickRenderer; // Instanced path for the brick field, if GL 3.3 is available
+CircleRenderer circleRenderer; // Instanced path for the ball, bullets and power-ups, likewise
+TextRenderer textRenderer; // Distance-field text, drawn once at the end of the frame; else GLUT bitmaps
+FrameUniforms frameUniforms; // Screen size for the three renderers above, in one uniform buffer
+InputRecorder recorder; // Log of this session's input, saved on exit for replay
+
+const int MAX_STEPS_PER_FRAME = 250; // Drop sim time rather than spiral after a long stall
+Ball prevBall; // Ball and paddle as of the tick before the latest, for interpolation
+Paddle prevPaddle;
+float renderAlpha = 1.0f; // Fraction of a tick the displayed frame lies past prevBall/prevPaddle
+
+float Lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+TextureAtlas sprites; // Every sprite image packed into one texture, bound once per frame
+ImageLoader imageLoader; // Decodes spriteFiles on worker threads while the menu is up
+bool spritesLoaded = false;
+AssetPack assetPack; // Pre-baked textures, font and sounds from Apps/AssetBaker, used in place of Image/, Font/ and Sound/ if present
+#ifdef _WIN32
+WaveOutSink audioSink; // Declared before audio, so it outlives the mixing thread
+#else
+NullSink audioSink;
+#endif
+AudioMixer audio; // Brick and bomb sounds, mixed on their own thread
+int sounds[NSOUNDS]; // AudioMixer ids, -1 if missing
+
+void loadSprites() {
+    // Upload what imageLoader decoded, waiting for any image still in flight; the bricks reuse the same images
+    imageLoader.wait();
+    if (!sprites.build(imageLoader.data(), NSPRITES)) {
+        std::cerr << "Failed to load some sprites" << std::endl;
+    }
+    const Image *brickLayers[BrickRenderer::NLAYERS];
+    for (int i = 0; i < BrickRenderer::NLAYERS; i++) {
+        brickLayers[i] = &imageLoader.image(brickLayerSprites[i]);
+    }
+    brickRenderer.init(brickLayers); // Falls back to drawBrick per brick if this fails
+    imageLoader.clear();
+    spritesLoaded = true;
+}
+
+bool loadPackedAssets() {
+    // Upload straight from the mapped pack: no decoding, resampling or mipmap generation
+    const PackEntry* page = assetPack.find(PACK_SPRITES, PACK_TEXTURE);
+    const PackEntry* rects = assetPack.find(PACK_SPRITE_RECTS, PACK_BLOB);
+    const PackEntry* bricks = assetPack.find(PACK_BRICKS, PACK_TEXTURE);
+    const PackEntry* font = assetPack.find(PACK_FONT, PACK_BLOB);
+    if (!page || !rects || !bricks || !font || rects->size != NSPRITES * (int) sizeof(AtlasRect) || bricks->params[2] != BrickRenderer::NLAYERS ||
+        !assetPack.textureFits(*page) || !assetPack.textureFits(*bricks)) {
+        std::cerr << "Asset pack is incomplete or damaged; loading from Image/ and Font/" << std::endl;
+        return false;
+    }
+    sprites.load(assetPack.data(*page), page->params[0], page->params[1], (const AtlasRect*) assetPack.data(*rects), NSPRITES);
+    brickRenderer.init(assetPack.data(*bricks), bricks->params[0], bricks->params[1], bricks->params[3]); // Falls back to drawBrick if this fails
+    textRenderer.init(assetPack.data(*font), font->size); // Falls back to GLUT bitmap text if this fails
+    spritesLoaded = true;
+    return true;
+}
+
+void loadSounds() {
+    // From the pack if it has them (and their size matches), else from Sound/; a missing sound is just silent
+    bool any = false;
+    for (int i = 0; i < NSOUNDS; i++) {
+        const PackEntry* e = assetPack.find(soundFiles[i], PACK_PCM);
+        if (e && e->params[1] >= 1 && e->params[1] <= 2 && e->params[2] >= 0 && (long long) e->params[2] * e->params[1] * 2 == e->size) {
+            sounds[i] = audio.addSound((const short*) assetPack.data(*e), e->params[2], e->params[1], e->params[0]);
         }
-        else if (channels == 4) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        else {
+            sounds[i] = audio.addSound(soundFiles[i]);
         }
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
+        any = any || sounds[i] >= 0;
     }
-    else {
-        std::cerr << "Failed to load bomb texture" << std::endl;
+    if (any) {
+        audio.start(&audioSink);
     }
 }
 
-
-void setupBricks() {
-    float startX = (SCREEN_WIDTH - (BRICK_COLS * (BRICK_WIDTH + BRICK_SPACING))) / 2.0f;
-    float startY = 50;
-    int bombCount = 0;
-    int maxBombs;
-
-    int totalBricks = BRICK_ROWS * BRICK_COLS;
-    int fireballCount, gunCount, flipCount, shrinkCount;
-
-    switch (level) {
-    case 1:
-        fireballCount = totalBricks * 0.20; // 20% Fireball power-ups
-        gunCount = 0;
-        flipCount = 0;
-        shrinkCount = 0;
-        maxBombs = 8 + rand() % 2; // 8-9 bombs
-        break;
-    case 2:
-        fireballCount = totalBricks * 0.15; // 15% Fireball power-ups
-        shrinkCount = totalBricks * 0.15; // 15% Shrink power-ups
-        gunCount = totalBricks * 0.10; // 10% Gun power-ups
-        flipCount = 0;
-        maxBombs = 3 + rand() % 2; // 3-4 bombs
-        break;
-    case 3:
-        fireballCount = totalBricks * 0.10; // 10% Fireball power-ups
-        shrinkCount = totalBricks * 0.10; // 10% Shrink power-ups
-        gunCount = totalBricks * 0.10; // 10% Gun power-ups
-        flipCount = totalBricks * 0.10; // 10% Flip power-ups
-        maxBombs = 2 + rand() % 2; // 2-3 bombs
-        break;
-    default:
-        fireballCount = 0;
-        gunCount = 0;
-        flipCount = 0;
-        shrinkCount = 0;
-        maxBombs = 0;
-    }
-
-    std::vector<int> brickIndices(totalBricks);
-    for (int i = 0; i < totalBricks; ++i) {
-        brickIndices[i] = i;
-    }
-    std::random_shuffle(brickIndices.begin(), brickIndices.end());
-
-    auto assignPowerUps = [&](int& count, PowerUpType type) {
-        while (count > 0) {
-            int index = brickIndices.back();
-            brickIndices.pop_back();
-            int row = index / BRICK_COLS;
-            int col = index % BRICK_COLS;
-            bricks[row * BRICK_COLS + col].hasPowerUp = true;
-            bricks[row * BRICK_COLS + col].powerUpType = type;
-            --count;
-        }
-        };
-
-    bricks.reserve(totalBricks);
-    for (int i = 0; i < BRICK_ROWS; ++i) {
-        for (int j = 0; j < BRICK_COLS; ++j) {
-            int type;
-            bool isBomb = false;
-
-            switch (level) {
-            case 1:
-                type = (rand() % 100 < 25) ? 2 : 1; // 25% 2-hit bricks, rest 1-hit bricks
-                break;
-            case 2:
-            {
-                int randVal = rand() % 100;
-                if (randVal < 30) {
-                    type = 2; // 30% 2-hit bricks
-                }
-                else if (randVal < 40) {
-                    type = 3; // 10% 3-hit bricks
-                }
-                else {
-                    type = 1; // rest 1-hit bricks
-                }
-            }
-            break;
-            case 3:
-            {
-                int randVal = rand() % 100;
-                if (randVal < 30) {
-                    type = 3; // 30% 3-hit bricks
-                }
-                else if (randVal < 70) {
-                    type = 2; // 40% 2-hit bricks
-                }
-                else {
-                    type = 1; // rest 1-hit bricks
-                }
-            }
-            break;
-            default:
-                type = 1;
-            }
-
-            bricks.emplace_back(startX + j * (BRICK_WIDTH + BRICK_SPACING), startY + i * (BRICK_HEIGHT + BRICK_SPACING), BRICK_WIDTH, BRICK_HEIGHT, type, false, FIREBALL, false);
-        }
+void playSounds() {
+    // One sound per kind per frame: a bomb's nine bricks are one blast, not nine breaks
+    if (world.blasts) {
+        audio.play(sounds[BOMB_SOUND]);
     }
-
-    // Place bombs ensuring they are not adjacent
-    std::vector<int> availableIndices;
-    for (int i = 0; i < totalBricks; ++i) {
-        availableIndices.push_back(i);
+    else if (world.breaks) {
+        audio.play(sounds[BREAK_SOUND]);
     }
-    std::random_shuffle(availableIndices.begin(), availableIndices.end());
-
-    while (bombCount < maxBombs && !availableIndices.empty()) {
-        int index = availableIndices.back();
-        availableIndices.pop_back();
-        int row = index / BRICK_COLS;
-        int col = index % BRICK_COLS;
-
-        // Check adjacent bricks
-        bool canPlaceBomb = true;
-        for (int dr = -1; dr <= 1; ++dr) {
-            for (int dc = -1; dc <= 1; ++dc) {
-                int newRow = row + dr;
-                int newCol = col + dc;
-                if (newRow >= 0 && newRow < BRICK_ROWS && newCol >= 0 && newCol < BRICK_COLS) {
-                    int adjacentIndex = newRow * BRICK_COLS + newCol;
-                    if (bricks[adjacentIndex].isBomb) {
-                        canPlaceBomb = false;
-                        break;
-                    }
-                }
-            }
-            if (!canPlaceBomb) break;
-        }
-
-        if (canPlaceBomb) {
-            bricks[index].isBomb = true;
-            bombCount++;
-        }
-    }
-
-    assignPowerUps(fireballCount, FIREBALL);
-    assignPowerUps(gunCount, GUN);
-    assignPowerUps(flipCount, FLIP);
-    assignPowerUps(shrinkCount, SHRINK); // Assign the SHRINK power-up
-
-    std::cout << "Total bombs placed: " << bombCount << std::endl; // Debug print for bombs count
+    world.breaks = world.blasts = 0;
 }
 
+float currentColor[3] = { 1.0f, 1.0f, 1.0f }; // Last setColor, which drawText uses as the text color
 
+void setColor(float r, float g, float b) {
+    currentColor[0] = r;
+    currentColor[1] = g;
+    currentColor[2] = b;
+    glColor3f(r, g, b);
+}
 
-void loadBrickTextures() {
-    int width, height, channels;
-    unsigned char* data;
-
-    // Load stage1.png
-    data = stbi_load("Image/stage1.png", &width, &height, &channels, 0);
-    if (data) {
-        glGenTextures(1, &brickTexture1);
-        glBindTexture(GL_TEXTURE_2D, brickTexture1);
-        if (channels == 3) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        }
-        else if (channels == 4) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        }
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
-    }
-    else {
-        std::cerr << "Failed to load stage1 texture" << std::endl;
+void drawText(const std::string& text, float x, float y, void* font) {
+    // (x, y) is the start of the baseline, as for glRasterPos2f
+    if (textRenderer.ready()) {
+        textRenderer.add(text, x, y, font == GLUT_BITMAP_TIMES_ROMAN_24 ? 24.0f : 18.0f, currentColor); // Same sizes as the GLUT fonts
+        return;
     }
-
-    // Load stage2.png
-    data = stbi_load("Image/stage2.png", &width, &height, &channels, 0);
-    if (data) {
-        glGenTextures(1, &brickTexture2);
-        glBindTexture(GL_TEXTURE_2D, brickTexture2);
-        if (channels == 3) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        }
-        else if (channels == 4) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        }
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
-    }
-    else {
-        std::cerr << "Failed to load stage2 texture" << std::endl;
+    Disable(GL_TEXTURE_2D); // Bitmap fragments are textured too
+    glRasterPos2f(x, y);
+    for (char ch : text) {
+        glutBitmapCharacter(font, ch);
     }
+}
 
-    // Load stage3.jpg
-    data = stbi_load("Image/stage3.jpg", &width, &height, &channels, 0);
-    if (data) {
-        glGenTextures(1, &brickTexture3);
-        glBindTexture(GL_TEXTURE_2D, brickTexture3);
-        if (channels == 3) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        }
-        else if (channels == 4) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        }
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
-    }
-    else {
-        std::cerr << "Failed to load stage3 texture" << std::endl;
-    }
+void spriteTexCoord(Sprite sprite, float s, float t) {
+    // (s, t) in [0, 1] across the sprite, as if it were its own texture
+    const AtlasRect& r = sprites.rect(sprite);
+    glTexCoord2f(r.u(s), r.v(t));
 }
 
 void drawBrick(const Brick& brick) {
     if (!brick.isVisible) return;
+    TRACE_ZONE("drawBrick"); // one immediate-mode quad; the atlas is already bound
 
+    Sprite sprite;
     if (brick.isBomb) {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, bombTexture);
-        glColor3f(1.0f, 1.0f, 1.0f); // Reset color to white for texture
-
-        glBegin(GL_QUADS);
-        glTexCoord2f(0.0f, 0.0f); glVertex2f(brick.x, brick.y);
-        glTexCoord2f(1.0f, 0.0f); glVertex2f(brick.x + brick.width, brick.y);
-        glTexCoord2f(1.0f, 1.0f); glVertex2f(brick.x + brick.width, brick.y + brick.height);
-        glTexCoord2f(0.0f, 1.0f); glVertex2f(brick.x, brick.y + brick.height);
-        glEnd();
-
-        glDisable(GL_TEXTURE_2D);
+        sprite = BOMB_SPRITE;
     }
     else {
-        GLuint textureID;
         switch (brick.hitsRemaining) {
-        case 1: textureID = brickTexture1; break;
-        case 2: textureID = brickTexture2; break;
-        case 3: textureID = brickTexture3; break;
+        case 1: sprite = STAGE1_SPRITE; break;
+        case 2: sprite = STAGE2_SPRITE; break;
+        case 3: sprite = STAGE3_SPRITE; break;
         default: return; // No texture for this brick
         }
-
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glColor3f(1.0f, 1.0f, 1.0f); // Reset color to white for texture
-
-        glBegin(GL_QUADS);
-        glTexCoord2f(0.0f, 0.0f); glVertex2f(brick.x, brick.y);
-        glTexCoord2f(1.0f, 0.0f); glVertex2f(brick.x + brick.width, brick.y);
-        glTexCoord2f(1.0f, 1.0f); glVertex2f(brick.x + brick.width, brick.y + brick.height);
-        glTexCoord2f(0.0f, 1.0f); glVertex2f(brick.x, brick.y + brick.height);
-        glEnd();
-
-        glDisable(GL_TEXTURE_2D);
     }
-}
 
-void destroySurroundingBricks(int bombIndex) {
-    int row = bombIndex / BRICK_COLS;
-    int col = bombIndex % BRICK_COLS;
-
-    for (int i = -1; i <= 1; ++i) {
-        for (int j = -1; j <= 1; ++j) {
-            if (i == 0 && j == 0) continue;
-            int newRow = row + i;
-            int newCol = col + j;
-
-            if (newRow >= 0 && newRow < BRICK_ROWS && newCol >= 0 && newCol < BRICK_COLS) {
-                int index = newRow * BRICK_COLS + newCol;
-                if (bricks[index].isVisible) {
-                    bricks[index].isVisible = false;
-                    score += 10;
-                }
-            }
-        }
-    }
-}
-
-void checkCollisions() {
-    // Check ball and brick collisions
-    for (int i = 0; i < bricks.size(); ++i) {
-        auto& brick = bricks[i];
-        if (brick.isVisible && ball.x + ball.radius > brick.x && ball.x - ball.radius < brick.x + brick.width &&
-            ball.y + ball.radius > brick.y && ball.y - ball.radius < brick.y + brick.height) {
-
-            float brickCenterX = brick.x + brick.width / 2.0f;
-            float brickCenterY = brick.y + brick.height / 2.0f;
-
-            if (brick.isBomb) {
-                destroySurroundingBricks(i);
-                brick.isVisible = false;
-                score += 10;
-                bricksBroken++;
-            }
-            else if (ball.isFireball) {
-                brick.isVisible = false;
-                score += 10; // Score for destroying brick
-                bricksBroken++;
-                if (brick.hasPowerUp) {
-                    powerUps.emplace_back(brick.x + brick.width / 2, brick.y + brick.height / 2, 0.0f, 0.05f, brick.powerUpType); // Adjust the dy value to 0.05f for slower falling speed
-                }
-            }
-            else {
-                brick.hitsRemaining--;
-                if (brick.hitsRemaining <= 0) {
-                    brick.isVisible = false;
-                    score += 10; // Score for destroying brick
-                    bricksBroken++;
-                    if (brick.hasPowerUp) {
-                        powerUps.emplace_back(brick.x + brick.width / 2, brick.y + brick.height / 2, 0.0f, 0.05f, brick.powerUpType); // Adjust the dy value to 0.05f for slower falling speed
-                    }
-                }
-
-                // Reflect ball based on hit position
-                float hitX = (ball.x - brickCenterX) / brick.width;
-                float hitY = (ball.y - brickCenterY) / brick.height;
-
-                if (fabs(hitX) > fabs(hitY)) {
-                    ball.dx = -ball.dx; // Horizontal collision
-                }
-                else {
-                    ball.dy = -ball.dy; // Vertical collision
-                }
+    Enable(GL_TEXTURE_2D);
+    setColor(1.0f, 1.0f, 1.0f); // Reset color to white for texture
 
-                ball.normalizeVelocity(); // Ensure ball doesn't change speed after collision
-            }
-
-            // Increase ball speed based on level and number of bricks broken
-            if (level == 2 && bricksBroken % 20 == 0) {
-                ball.setSpeed(ball.dx * 1.1f);
-            }
-            else if (level == 3 && bricksBroken % 15 == 0) {
-                ball.setSpeed(ball.dx * 1.1f);
-            }
-
-            break;
-        }
-    }
-
-    // Check bullet and brick collisions
-    for (auto& bullet : bullets) {
-        if (!bullet.active) continue;
-        for (auto& brick : bricks) {
-            if (brick.isVisible && bullet.x > brick.x && bullet.x < brick.x + brick.width &&
-                bullet.y > brick.y && bullet.y < brick.y + brick.height) {
-                brick.isVisible = false;
-                bullet.active = false;
-                score += 50; // Score for destroying brick with Gun
-                bricksBroken++;
-                break;
-            }
-        }
-    }
-
-    // Check ball and paddle collisions
-    if (ball.y + ball.radius >= paddle.y && ball.y - ball.radius <= paddle.y + paddle.height &&
-        ball.x + ball.radius >= paddle.x && ball.x - ball.radius <= paddle.x + paddle.width) {
-        ball.dy = -fabs(ball.dy); // Always reflect the ball upward
-
-        // Adjust the ball's horizontal direction based on where it hits the paddle
-        float hitPos = (ball.x - paddle.x) / paddle.width;
-        ball.dx = (hitPos - 0.5f) * 2 * BALL_SPEED_L1;
-
-        ball.normalizeVelocity(); // Keep the ball speed constant after collision
-    }
-
-    // Wall collisions
-    if (ball.x - ball.radius < 0 || ball.x + ball.radius > SCREEN_WIDTH) {
-        ball.dx = -ball.dx; // Bounce off left and right walls
-        ball.normalizeVelocity(); // Keep the ball speed constant after collision
-    }
-    if (ball.y - ball.radius < 0) {
-        ball.dy = -ball.dy; // Bounce off top wall
-        ball.normalizeVelocity(); // Keep the ball speed constant after collision
-    }
-    if (ball.y + ball.radius > SCREEN_HEIGHT) {
-        // Ball goes out of bounds
-
-        if (lives > 0) {
-            resetAfterLifeLost = true;
-            ball.idle = true;
-            ball.x = SCREEN_WIDTH / 2; // Reset ball position
-            ball.y = SCREEN_HEIGHT - 50;
-            ball.dx = 0.4f; // Reset ball speed
-            ball.dy = -0.4f;
-            paddle.x = (SCREEN_WIDTH - PADDLE_WIDTH) / 2; // Reset paddle position
-            currentGameState = AIM; // Set game state to AIM to show aiming line
-        }
-        else {
-            currentGameState = GAME_OVER;
-        }
-        lives--;
-    }
+    glBegin(GL_QUADS);
+    spriteTexCoord(sprite, 0.0f, 0.0f); glVertex2f(brick.x, brick.y);
+    spriteTexCoord(sprite, 1.0f, 0.0f); glVertex2f(brick.x + brick.width, brick.y);
+    spriteTexCoord(sprite, 1.0f, 1.0f); glVertex2f(brick.x + brick.width, brick.y + brick.height);
+    spriteTexCoord(sprite, 0.0f, 1.0f); glVertex2f(brick.x, brick.y + brick.height);
+    glEnd();
 }
 
-GLuint bulletTexture;
-
-void loadBulletTexture() {
-    int width, height, channels;
-    unsigned char* data = stbi_load("Image/bullet1.png", &width, &height, &channels, 0);
-    if (data) {
-        glGenTextures(1, &bulletTexture);
-        glBindTexture(GL_TEXTURE_2D, bulletTexture);
-        if (channels == 3) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        }
-        else if (channels == 4) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        }
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
+void drawBricks() {
+    TRACE_ZONE("drawBricks");
+    if (brickRenderer.ready()) {
+        brickRenderer.sync(world.bricks, world.brickLayout, world.changedBricks);
+        brickRenderer.draw();
     }
     else {
-        std::cerr << "Failed to load bullet texture" << std::endl;
+        for (const auto& brick : world.bricks) drawBrick(brick);
     }
 }
 
-void loadFireballTexture() {
-    int width, height, channels;
-    unsigned char* data = stbi_load("Image/fireball.png", &width, &height, &channels, 0);
-    if (data) {
-        glGenTextures(1, &fireballTexture);
-        glBindTexture(GL_TEXTURE_2D, fireballTexture);
-        if (channels == 3) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        }
-        else if (channels == 4) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        }
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
-    }
-    else {
-        std::cerr << "Failed to load fireball texture" << std::endl;
-    }
-}
+
 
 void drawBall() {
-    if (ball.isFireball) {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, fireballTexture);
+    TRACE_ZONE("drawBall");
+    Ball ball = world.ball;
+    if (prevBall.idle == ball.idle) { // No interpolation across a reset
+        ball.x = Lerp(prevBall.x, ball.x, renderAlpha);
+        ball.y = Lerp(prevBall.y, ball.y, renderAlpha);
     }
-    else if (ball.hasGun) {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, bulletTexture);
+    Sprite sprite = ball.isFireball ? FIREBALL_SPRITE : BULLET_SPRITE;
+    if (circleRenderer.ready()) {
+        circleRenderer.add(ball.x, ball.y, ball.radius, ball.isFireball || ball.hasGun ? &sprites.rect(sprite) : nullptr);
+        return;
+    }
+    if (ball.isFireball || ball.hasGun) {
+        Enable(GL_TEXTURE_2D);
     }
     else {
-        glDisable(GL_TEXTURE_2D);
-        glColor3f(1.0f, 1.0f, 1.0f); // White color for regular ball
+        Disable(GL_TEXTURE_2D);
+        setColor(1.0f, 1.0f, 1.0f); // White color for regular ball
     }
 
     glBegin(GL_TRIANGLE_FAN);
     for (int i = 0; i <= 360; i += 30) {
-        float degInRad = i * M_PI / 180;
+        float degInRad = i * PI / 180;
         float x = cos(degInRad) * ball.radius + ball.x;
         float y = sin(degInRad) * ball.radius + ball.y;
         if (ball.isFireball || ball.hasGun) {
-            glTexCoord2f((cos(degInRad) + 1.0f) / 2.0f, (sin(degInRad) + 1.0f) / 2.0f);
+            spriteTexCoord(sprite, (cos(degInRad) + 1.0f) / 2.0f, (sin(degInRad) + 1.0f) / 2.0f);
         }
         glVertex2f(x, y);
     }
     glEnd();
-
-    if (ball.isFireball || ball.hasGun) {
-        glDisable(GL_TEXTURE_2D);
-    }
 }
 
 
 void drawPaddle() {
+    TRACE_ZONE("drawPaddle");
+    Paddle paddle = world.paddle;
+    if (prevBall.idle == world.ball.idle) {
+        paddle.x = Lerp(prevPaddle.x, paddle.x, renderAlpha);
+    }
+    Disable(GL_TEXTURE_2D);
     glBegin(GL_QUADS);
     glVertex2f(paddle.x, paddle.y);
     glVertex2f(paddle.x + paddle.width, paddle.y);
@@ -638,183 +234,84 @@ void drawPaddle() {
 }
 
 void drawBullets() {
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, bulletTexture);
+    TRACE_ZONE("drawBullets");
+    if (circleRenderer.ready()) {
+        for (auto bullet : world.bullets) {
+            if (bullet.active) {
+                circleRenderer.add(bullet.x, bullet.y - bullet.dy * (1.0f - renderAlpha), 5, &sprites.rect(BULLET_SPRITE));
+            }
+        }
+        return;
+    }
+    Enable(GL_TEXTURE_2D);
 
-    for (const auto& bullet : bullets) {
+    for (auto bullet : world.bullets) {
         if (bullet.active) {
+            bullet.y -= bullet.dy * (1.0f - renderAlpha); // Constant velocity, so back up to the frame time
             glBegin(GL_TRIANGLE_FAN);
-            glTexCoord2f(0.5f, 0.5f); glVertex2f(bullet.x, bullet.y);
+            spriteTexCoord(BULLET_SPRITE, 0.5f, 0.5f); glVertex2f(bullet.x, bullet.y);
             for (int i = 0; i <= 360; i += 30) {
-                float degInRad = i * M_PI / 180;
-                glTexCoord2f((cos(degInRad) + 1.0f) / 2.0f, (sin(degInRad) + 1.0f) / 2.0f);
+                float degInRad = i * PI / 180;
+                spriteTexCoord(BULLET_SPRITE, (cos(degInRad) + 1.0f) / 2.0f, (sin(degInRad) + 1.0f) / 2.0f);
                 glVertex2f(cos(degInRad) * 5 + bullet.x, sin(degInRad) * 5 + bullet.y);
             }
             glEnd();
         }
     }
-
-    glDisable(GL_TEXTURE_2D);
 }
 
 void drawPowerUps() {
-    for (const auto& powerUp : powerUps) {
+    TRACE_ZONE("drawPowerUps");
+    for (auto powerUp : world.powerUps) {
         if (powerUp.active) {
-            if (powerUp.type == FIREBALL) {
-                glEnable(GL_TEXTURE_2D);
-                glBindTexture(GL_TEXTURE_2D, fireballTexture);
+            powerUp.x -= powerUp.dx * (1.0f - renderAlpha);
+            powerUp.y -= powerUp.dy * (1.0f - renderAlpha);
+            Sprite sprite = powerUp.type == FIREBALL ? FIREBALL_SPRITE : BULLET_SPRITE;
+            if (circleRenderer.ready()) {
+                if (powerUp.type == FLIP) {
+                    circleRenderer.add(powerUp.x, powerUp.y, powerUp.radius, nullptr, 0.0f, 0.0f, 1.0f); // Blue
+                }
+                else if (powerUp.type == SHRINK) {
+                    circleRenderer.add(powerUp.x, powerUp.y, powerUp.radius, nullptr, 1.0f, 0.0f, 1.0f); // Purple
+                }
+                else {
+                    circleRenderer.add(powerUp.x, powerUp.y, powerUp.radius, &sprites.rect(sprite));
+                }
+                continue;
             }
-            else if (powerUp.type == GUN) {
-                glEnable(GL_TEXTURE_2D);
-                glBindTexture(GL_TEXTURE_2D, bulletTexture);
+            if (powerUp.type == FIREBALL || powerUp.type == GUN) {
+                Enable(GL_TEXTURE_2D);
             }
             else if (powerUp.type == FLIP) {
-                glDisable(GL_TEXTURE_2D);
-                glColor3f(0.0f, 0.0f, 1.0f); // Blue color for flip power-up
+                Disable(GL_TEXTURE_2D);
+                setColor(0.0f, 0.0f, 1.0f); // Blue color for flip power-up
             }
             else if (powerUp.type == SHRINK) {
-                glDisable(GL_TEXTURE_2D);
-                glColor3f(1.0f, 0.0f, 1.0f); // Purple color for shrink power-up
+                Disable(GL_TEXTURE_2D);
+                setColor(1.0f, 0.0f, 1.0f); // Purple color for shrink power-up
             }
 
             glBegin(GL_TRIANGLE_FAN);
-            glTexCoord2f(0.5f, 0.5f); glVertex2f(powerUp.x, powerUp.y);
+            spriteTexCoord(sprite, 0.5f, 0.5f); glVertex2f(powerUp.x, powerUp.y);
             for (int j = 0; j <= 360; j += 30) {
-                float degInRad = j * M_PI / 180;
-                glTexCoord2f((cos(degInRad) + 1.0f) / 2.0f, (sin(degInRad) + 1.0f) / 2.0f);
+                float degInRad = j * PI / 180;
+                spriteTexCoord(sprite, (cos(degInRad) + 1.0f) / 2.0f, (sin(degInRad) + 1.0f) / 2.0f);
                 glVertex2f(cos(degInRad) * powerUp.radius + powerUp.x, sin(degInRad) * powerUp.radius + powerUp.y);
             }
             glEnd();
 
-            if (powerUp.type == FIREBALL || powerUp.type == GUN) {
-                glDisable(GL_TEXTURE_2D);
-            }
-            else {
-                glColor3f(1.0f, 1.0f, 1.0f); // Reset color to white after drawing colored power-ups
+            if (powerUp.type != FIREBALL && powerUp.type != GUN) {
+                setColor(1.0f, 1.0f, 1.0f); // Reset color to white after drawing colored power-ups
             }
         }
     }
 }
 
-bool checkPowerUpCollision(PowerUp& powerUp) {
-    if (powerUp.active) {
-        // Check collision with paddle
-        if (powerUp.y + powerUp.radius >= paddle.y && powerUp.x >= paddle.x && powerUp.x <= paddle.x + paddle.width) {
-            // Apply power-up effect
-            if (powerUp.type == FIREBALL) { // Fireball power-up
-                ball.isFireball = true;
-                ball.hasGun = false; // Deactivate Gun power-up
-                ball.gunAmmo = 0;
-                ball.powerUpStartTime = time(nullptr);
-            }
-            else if (powerUp.type == GUN) { // Gun power-up
-                ball.hasGun = true;
-                ball.isFireball = false; // Deactivate Fireball power-up
-                ball.gunAmmo = 3;
-            }
-            else if (powerUp.type == FLIP) { // Flip power-up
-                paddle.controlsFlipped = !paddle.controlsFlipped;
-            }
-            else if (powerUp.type == SHRINK) { // Shrink power-up
-                if (!paddle.isShrunk) {
-                    paddle.width *= SHRINK_FACTOR;
-                    paddle.isShrunk = true;
-                    paddle.shrinkStartTime = time(nullptr);
-                }
-            }
-            powerUp.active = false; // Deactivate power-up
-            return true; // Collision detected
-        }
-    }
-    return false; // No collision
-}
 
-void updateBall() {
-    if (ball.isFireball && difftime(time(nullptr), ball.powerUpStartTime) >= FIREBALL_DURATION) {
-        ball.isFireball = false;
-        ball.resetPowerUp();
-    }
 
-    if (!ball.idle) {
-        ball.x += ball.dx;
-        ball.y += ball.dy;
-        checkCollisions();
-    }
 
-    if (ball.y > paddle.y + paddle.height) {
-        // Ball goes out of bounds
-        lives--;
-        if (lives > 0) {
-            resetAfterLifeLost = true;
-            ball.idle = true;
-            ball.x = SCREEN_WIDTH / 2; // Reset ball position
-            ball.y = SCREEN_HEIGHT - 50;
-            ball.dx = 0.4f; // Reset ball speed
-            ball.dy = -0.4f;
-            paddle.x = (SCREEN_WIDTH - PADDLE_WIDTH) / 2; // Reset paddle position
-            paddle.moveLeft = false; // Reset paddle movement flags
-            paddle.moveRight = false; // Reset paddle movement flags
-            currentGameState = AIM; // Set game state to AIM to show aiming line
-        }
-        else {
-            currentGameState = GAME_OVER;
-        }
-    }
-}
-
-void updateFireball() {
-    // Check if the fireball state has expired
-    if (ball.isFireball && difftime(time(nullptr), ball.powerUpStartTime) >= FIREBALL_DURATION) {
-        ball.isFireball = false;
-        ball.resetPowerUp();
-    }
-}
-
-void shootGun() {
-    if (ball.hasGun && ball.gunAmmo > 0) {
-        bullets.emplace_back(paddle.x + paddle.width / 2, paddle.y);
-        ball.gunAmmo--;
-        if (ball.gunAmmo == 0) {
-            ball.hasGun = false; // Deactivate Gun if ammo is depleted
-        }
-    }
-}
-
-void updateBullets() {
-    for (auto& bullet : bullets) {
-        if (bullet.active) {
-            bullet.y += bullet.dy;
-            if (bullet.y < 0) {
-                bullet.active = false;
-            }
-        }
-    }
-    bullets.erase(std::remove_if(bullets.begin(), bullets.end(), [](const Bullet& b) { return !b.active; }), bullets.end());
-}
 
-void updatePaddle() {
-    if (paddle.isShrunk && difftime(time(nullptr), paddle.shrinkStartTime) >= SHRINK_DURATION) {
-        paddle.width = PADDLE_WIDTH;
-        paddle.isShrunk = false;
-    }
 
-    if (paddle.controlsFlipped) {
-        if (paddle.moveLeft && paddle.x + paddle.width < SCREEN_WIDTH) {
-            paddle.x += PADDLE_SPEED;
-        }
-        if (paddle.moveRight && paddle.x > 0) {
-            paddle.x -= PADDLE_SPEED;
-        }
-    }
-    else {
-        if (paddle.moveLeft && paddle.x > 0) {
-            paddle.x -= PADDLE_SPEED;
-        }
-        if (paddle.moveRight && paddle.x + paddle.width < SCREEN_WIDTH) {
-            paddle.x += PADDLE_SPEED;
-        }
-    }
-}
 
 void initOpenGL() {
     glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
@@ -822,46 +319,22 @@ void initOpenGL() {
     glLoadIdentity();
     glOrtho(0.0, SCREEN_WIDTH, SCREEN_HEIGHT, 0.0, 1.0, -1.0);
     glMatrixMode(GL_MODELVIEW);
-    glEnable(GL_DEPTH_TEST);
+    Enable(GL_DEPTH_TEST);
     glClearColor(0.0, 0.0, 0.0, 1.0);
 }
 
 void drawScore() {
-    glColor3f(1.0f, 1.0f, 1.0f); // Set text color to white
-    glRasterPos2f(10, SCREEN_HEIGHT - 30); // Set the position of the text
-
-    std::string scoreString = "Score: " + std::to_string(score); // Convert the score to string
-    for (char ch : scoreString) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the score string
-    }
+    setColor(1.0f, 1.0f, 1.0f); // Set text color to white
+    std::string scoreString = "Score: " + std::to_string(world.score); // Convert the score to string
+    drawText(scoreString, 10, SCREEN_HEIGHT - 30, GLUT_BITMAP_TIMES_ROMAN_24);
 }
 
-void updatePowerUps() {
-    for (auto& powerUp : powerUps) {
-        if (powerUp.active) {
-            powerUp.x += powerUp.dx;
-            powerUp.y += powerUp.dy;
-            // Check collision with paddle
-            if (checkPowerUpCollision(powerUp)) {
-                // Power-up collision handled inside checkPowerUpCollision
-            }
-            // Check if power-up goes out of bounds
-            if (powerUp.y > SCREEN_HEIGHT) {
-                powerUp.active = false;
-            }
-        }
-    }
-}
 
 void drawAmmoCount() {
-    if (ball.hasGun) {
-        glColor3f(1.0f, 1.0f, 1.0f); // Set text color to white
-        glRasterPos2f(SCREEN_WIDTH - 100, SCREEN_HEIGHT - 30); // Set the position of the text
-
-        std::string ammoString = "Ammo: " + std::to_string(ball.gunAmmo); // Convert the ammo count to string
-        for (char ch : ammoString) {
-            glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the ammo string
-        }
+    if (world.ball.hasGun) {
+        setColor(1.0f, 1.0f, 1.0f); // Set text color to white
+        std::string ammoString = "Ammo: " + std::to_string(world.ball.gunAmmo); // Convert the ammo count to string
+        drawText(ammoString, SCREEN_WIDTH - 100, SCREEN_HEIGHT - 30, GLUT_BITMAP_TIMES_ROMAN_24);
     }
 }
 
@@ -889,29 +362,22 @@ void drawMenu() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Draw the menu title with a larger font and color
-    glColor3f(1.0f, 0.0f, 0.0f);  // Set the color to red
-    glRasterPos2f(SCREEN_WIDTH / 2 - 75, SCREEN_HEIGHT / 2 - 150);  // Adjust the position as needed
+    setColor(1.0f, 0.0f, 0.0f);  // Set the color to red
     std::string menuText = "Game Menu";
-    for (char ch : menuText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch);  // Use a larger font
-    }
+    drawText(menuText, SCREEN_WIDTH / 2 - 75, SCREEN_HEIGHT / 2 - 150, GLUT_BITMAP_TIMES_ROMAN_24);
 
     int offsetY = 40;  // Reduce the space between options
     for (int i = 0; i < 4; ++i) {  // Updated loop to iterate over 4 options
-        glRasterPos2f(SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 - 50 + i * offsetY); // Adjust the vertical position
-
         //std::cout << "Option: " << options[i] << ", Position: " << (SCREEN_HEIGHT / 2 - 50 + i * offsetY) << ", Selected: " << (i == menuSelection) << std::endl;
 
         if (i == menuSelection) {
-            glColor3f(0.0f, 1.0f, 0.0f); // Highlight selected option in green
+            setColor(0.0f, 1.0f, 0.0f); // Highlight selected option in green
         }
         else {
-            glColor3f(1.0f, 1.0f, 1.0f); // White color for non-selected options
+            setColor(1.0f, 1.0f, 1.0f); // White color for non-selected options
         }
 
-        for (char c : options[i]) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
-        }
+        drawText(options[i], SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 - 50 + i * offsetY, GLUT_BITMAP_HELVETICA_18);
     }
 
     // Flush the rendering pipeline to ensure all commands are processed
@@ -924,14 +390,11 @@ void drawInstructions() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Set color for the text
-    glColor3f(1.0f, 1.0f, 1.0f); // White color for text
+    setColor(1.0f, 1.0f, 1.0f); // White color for text
 
     // Draw the instructions title
-    glRasterPos2f(SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 250 + scrollOffset);
     std::string instructionsTitle = "Instructions";
-    for (char ch : instructionsTitle) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch);
-    }
+    drawText(instructionsTitle, SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 250 + scrollOffset, GLUT_BITMAP_TIMES_ROMAN_24);
 
     // Instructions for the game with symbols
     std::vector<std::string> instructions = {
@@ -947,10 +410,7 @@ void drawInstructions() {
     // Draw the instructions text with symbols
     int offsetY = 80;
     for (const auto& line : instructions) {
-        glRasterPos2f(SCREEN_WIDTH / 2 - 250, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset);
-        for (char ch : line) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-        }
+        drawText(line, SCREEN_WIDTH / 2 - 250, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset, GLUT_BITMAP_HELVETICA_18);
         offsetY += 30;
     }
 
@@ -964,56 +424,35 @@ void drawInstructions() {
     // Draw the level details
     offsetY += 20; // Add extra space before level details
     for (const auto& line : levelDetails) {
-        glRasterPos2f(SCREEN_WIDTH / 2 - 250, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset);
-        for (char ch : line) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-        }
+        drawText(line, SCREEN_WIDTH / 2 - 250, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset, GLUT_BITMAP_HELVETICA_18);
         offsetY += 30;
     }
 
     // Draw the control keys using symbols
     offsetY += 20; // Add extra space before control keys
-    glRasterPos2f(SCREEN_WIDTH / 2 - 250, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset);
     std::string controlKeys = "Control Keys:";
-    for (char ch : controlKeys) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-    }
+    drawText(controlKeys, SCREEN_WIDTH / 2 - 250, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset, GLUT_BITMAP_HELVETICA_18);
 
     offsetY += 30;
-    glRasterPos2f(SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset);
     std::string leftArrow = "<- Move Left";
-    for (char ch : leftArrow) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-    }
+    drawText(leftArrow, SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset, GLUT_BITMAP_HELVETICA_18);
 
     offsetY += 30;
-    glRasterPos2f(SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset);
     std::string rightArrow = "-> Move Right";
-    for (char ch : rightArrow) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-    }
+    drawText(rightArrow, SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset, GLUT_BITMAP_HELVETICA_18);
 
     offsetY += 30;
-    glRasterPos2f(SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset);
     std::string spaceKey = "[SPACE] Start Ball";
-    for (char ch : spaceKey) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-    }
+    drawText(spaceKey, SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset, GLUT_BITMAP_HELVETICA_18);
 
     offsetY += 30;
-    glRasterPos2f(SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset);
     std::string enterKey = "[ENTER] Select Option";
-    for (char ch : enterKey) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-    }
+    drawText(enterKey, SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset, GLUT_BITMAP_HELVETICA_18);
 
     // Draw back button
     offsetY += 50; // Add extra space before the back button
-    glRasterPos2f(SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset);
     std::string backButton = "Press ESC to go back";
-    for (char ch : backButton) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-    }
+    drawText(backButton, SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 250 + offsetY + scrollOffset, GLUT_BITMAP_HELVETICA_18);
 
     // Flush the rendering pipeline
     glFlush();
@@ -1024,14 +463,11 @@ void drawPowerUpsScreen() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Set color for the text
-    glColor3f(1.0f, 1.0f, 1.0f); // White color for text
+    setColor(1.0f, 1.0f, 1.0f); // White color for text
 
     // Draw the power-ups title
-    glRasterPos2f(SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 200);
     std::string powerUpsTitle = "Power-Ups";
-    for (char ch : powerUpsTitle) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch);
-    }
+    drawText(powerUpsTitle, SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 200, GLUT_BITMAP_TIMES_ROMAN_24);
 
     // Power-ups descriptions
     std::vector<std::string> powerUpsDescriptions = {
@@ -1052,33 +488,29 @@ void drawPowerUpsScreen() {
     for (int i = 0; i < powerUpsDescriptions.size(); ++i) {
         // Draw the power-up color circle or image
         if (i < 2) { // Use images for Fireball and Gun
-            GLuint textureID = (i == 0) ? fireballTexture : bulletTexture;
-            glEnable(GL_TEXTURE_2D);
-            glBindTexture(GL_TEXTURE_2D, textureID);
+            Sprite sprite = (i == 0) ? FIREBALL_SPRITE : BULLET_SPRITE;
+            Enable(GL_TEXTURE_2D);
             glBegin(GL_QUADS);
-            glTexCoord2f(0.0f, 0.0f); glVertex2f(SCREEN_WIDTH / 2 - 230, SCREEN_HEIGHT / 2 - 120 + offsetY - 10);
-            glTexCoord2f(1.0f, 0.0f); glVertex2f(SCREEN_WIDTH / 2 - 210, SCREEN_HEIGHT / 2 - 120 + offsetY - 10);
-            glTexCoord2f(1.0f, 1.0f); glVertex2f(SCREEN_WIDTH / 2 - 210, SCREEN_HEIGHT / 2 - 120 + offsetY + 10);
-            glTexCoord2f(0.0f, 1.0f); glVertex2f(SCREEN_WIDTH / 2 - 230, SCREEN_HEIGHT / 2 - 120 + offsetY + 10);
+            spriteTexCoord(sprite, 0.0f, 0.0f); glVertex2f(SCREEN_WIDTH / 2 - 230, SCREEN_HEIGHT / 2 - 120 + offsetY - 10);
+            spriteTexCoord(sprite, 1.0f, 0.0f); glVertex2f(SCREEN_WIDTH / 2 - 210, SCREEN_HEIGHT / 2 - 120 + offsetY - 10);
+            spriteTexCoord(sprite, 1.0f, 1.0f); glVertex2f(SCREEN_WIDTH / 2 - 210, SCREEN_HEIGHT / 2 - 120 + offsetY + 10);
+            spriteTexCoord(sprite, 0.0f, 1.0f); glVertex2f(SCREEN_WIDTH / 2 - 230, SCREEN_HEIGHT / 2 - 120 + offsetY + 10);
             glEnd();
-            glDisable(GL_TEXTURE_2D);
         }
         else { // Use colors for Flip and Shrink
-            glColor3f(powerUpColors[i - 2][0], powerUpColors[i - 2][1], powerUpColors[i - 2][2]);
+            Disable(GL_TEXTURE_2D);
+            setColor(powerUpColors[i - 2][0], powerUpColors[i - 2][1], powerUpColors[i - 2][2]);
             glBegin(GL_TRIANGLE_FAN);
             for (int j = 0; j <= 360; j += 30) {
-                float degInRad = j * M_PI / 180;
+                float degInRad = j * PI / 180;
                 glVertex2f(cos(degInRad) * 10 + SCREEN_WIDTH / 2 - 220, sin(degInRad) * 10 + SCREEN_HEIGHT / 2 - 120 + offsetY);
             }
             glEnd();
         }
 
         // Draw the power-up description text
-        glColor3f(1.0f, 1.0f, 1.0f); // White color for text
-        glRasterPos2f(SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 120 + offsetY);
-        for (char ch : powerUpsDescriptions[i]) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-        }
+        setColor(1.0f, 1.0f, 1.0f); // White color for text
+        drawText(powerUpsDescriptions[i], SCREEN_WIDTH / 2 - 200, SCREEN_HEIGHT / 2 - 120 + offsetY, GLUT_BITMAP_HELVETICA_18);
         offsetY += 30;
     }
 
@@ -1089,51 +521,40 @@ void drawPowerUpsScreen() {
         "3 Hits"
     };
 
-    // Brick textures
-    std::vector<GLuint> brickTextures = { brickTexture1, brickTexture2, brickTexture3 };
+    // Brick sprites
+    Sprite brickSprites[] = { STAGE1_SPRITE, STAGE2_SPRITE, STAGE3_SPRITE };
 
     offsetY = 50;
     for (int i = 0; i < brickDescriptions.size(); ++i) {
         // Draw the brick texture rectangle
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, brickTextures[i]);
+        Enable(GL_TEXTURE_2D);
         glBegin(GL_QUADS);
-        glTexCoord2f(0.0f, 0.0f); glVertex2f(SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + offsetY - 10);
-        glTexCoord2f(1.0f, 0.0f); glVertex2f(SCREEN_WIDTH / 2 - 130, SCREEN_HEIGHT / 2 + offsetY - 10);
-        glTexCoord2f(1.0f, 1.0f); glVertex2f(SCREEN_WIDTH / 2 - 130, SCREEN_HEIGHT / 2 + offsetY + 10);
-        glTexCoord2f(0.0f, 1.0f); glVertex2f(SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + offsetY + 10);
+        spriteTexCoord(brickSprites[i], 0.0f, 0.0f); glVertex2f(SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + offsetY - 10);
+        spriteTexCoord(brickSprites[i], 1.0f, 0.0f); glVertex2f(SCREEN_WIDTH / 2 - 130, SCREEN_HEIGHT / 2 + offsetY - 10);
+        spriteTexCoord(brickSprites[i], 1.0f, 1.0f); glVertex2f(SCREEN_WIDTH / 2 - 130, SCREEN_HEIGHT / 2 + offsetY + 10);
+        spriteTexCoord(brickSprites[i], 0.0f, 1.0f); glVertex2f(SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + offsetY + 10);
         glEnd();
-        glDisable(GL_TEXTURE_2D);
 
         // Draw the brick description text
-        glColor3f(1.0f, 1.0f, 1.0f);
-        glRasterPos2f(SCREEN_WIDTH / 2 - 110, SCREEN_HEIGHT / 2 + offsetY);
-        for (char ch : brickDescriptions[i]) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-        }
+        setColor(1.0f, 1.0f, 1.0f);
+        drawText(brickDescriptions[i], SCREEN_WIDTH / 2 - 110, SCREEN_HEIGHT / 2 + offsetY, GLUT_BITMAP_HELVETICA_18);
         offsetY += 30; // Move to the next line
     }
 
     // Draw back button
-    glRasterPos2f(SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 + 150);
     std::string backButton = "Press ESC to go back";
-    for (char ch : backButton) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, ch);
-    }
+    drawText(backButton, SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 + 150, GLUT_BITMAP_HELVETICA_18);
 
     // Flush the rendering pipeline
     glFlush();
 }
 
 void drawLevelSelect() {
-    glColor3f(1.0f, 1.0f, 1.0f); // White color for text
+    setColor(1.0f, 1.0f, 1.0f); // White color for text
 
     // Centering text position for the level selection message
-    glRasterPos2f(SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 50);
     std::string levelSelectText = "Select Level:";
-    for (char ch : levelSelectText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the text
-    }
+    drawText(levelSelectText, SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 50, GLUT_BITMAP_TIMES_ROMAN_24);
 
     // List of levels
     std::string levels[] = {
@@ -1145,143 +566,77 @@ void drawLevelSelect() {
 
     int offsetY = 30;
     for (const std::string& line : levels) {
-        glRasterPos2f(SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 + offsetY);
-        for (char ch : line) {
-            glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the text
-        }
+        drawText(line, SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 + offsetY, GLUT_BITMAP_TIMES_ROMAN_24);
         offsetY += 30; // Move to the next line
     }
 }
 
 void drawGameOver() {
-    glColor3f(1.0f, 0.0f, 0.0f); // Red color for text
-    glRasterPos2f(SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2); // Centering text position
+    setColor(1.0f, 0.0f, 0.0f); // Red color for text
     std::string gameOverText = "GAME OVER! Press ENTER to restart or ESC to exit";
-    for (char ch : gameOverText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the text
-    }
+    drawText(gameOverText, SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2, GLUT_BITMAP_TIMES_ROMAN_24);
 
     // Display current score
-    std::string scoreText = "Score: " + std::to_string(score);
-    glRasterPos2f(SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 + 30); // Adjust position as needed
-    for (char ch : scoreText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the score text
-    }
+    std::string scoreText = "Score: " + std::to_string(world.score);
+    drawText(scoreText, SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 + 30, GLUT_BITMAP_TIMES_ROMAN_24);
 }
 
 
 void drawWin() {
-    glColor3f(1.0f, 1.0f, 1.0f); // White color for text
-    glRasterPos2f(SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 50); // Centering text position
+    setColor(1.0f, 1.0f, 1.0f); // White color for text
     std::string winText = "Congratulations! You win!";
-    for (char ch : winText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the text
-    }
+    drawText(winText, SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 50, GLUT_BITMAP_TIMES_ROMAN_24);
 
     // Display current score
-    std::string scoreText = "Score: " + std::to_string(score);
-    glRasterPos2f(SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 - 20); // Adjust position as needed
-    for (char ch : scoreText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the score text
-    }
+    std::string scoreText = "Score: " + std::to_string(world.score);
+    drawText(scoreText, SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 - 20, GLUT_BITMAP_TIMES_ROMAN_24);
 
     std::string restartText = "Press ENTER to restart or ESC to exit";
-    glRasterPos2f(SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 20); // Adjust position as needed
-    for (char ch : restartText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the text
-    }
+    drawText(restartText, SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 20, GLUT_BITMAP_TIMES_ROMAN_24);
 }
 
 void drawLevelComplete() {
-    glColor3f(1.0f, 1.0f, 1.0f); // White color for text
-    glRasterPos2f(SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 50); // Centering text position
+    setColor(1.0f, 1.0f, 1.0f); // White color for text
     std::string levelCompleteText = "Congratulations! Level Complete!";
-    for (char ch : levelCompleteText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the text
-    }
+    drawText(levelCompleteText, SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 50, GLUT_BITMAP_TIMES_ROMAN_24);
 
     // Display current score
-    std::string scoreText = "Score: " + std::to_string(score);
-    glRasterPos2f(SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 - 20); // Adjust position as needed
-    for (char ch : scoreText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the score text
-    }
+    std::string scoreText = "Score: " + std::to_string(world.score);
+    drawText(scoreText, SCREEN_WIDTH / 2 - 50, SCREEN_HEIGHT / 2 - 20, GLUT_BITMAP_TIMES_ROMAN_24);
 
     std::string nextLevelText = "Press ENTER to start the next level or ESC to exit";
-    glRasterPos2f(SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 20); // Adjust position as needed
-    for (char ch : nextLevelText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the text
-    }
+    drawText(nextLevelText, SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 20, GLUT_BITMAP_TIMES_ROMAN_24);
 }
 
 
 void drawAimingLine() {
-    // Draw the bricks
-    for (const auto& brick : bricks) drawBrick(brick);
-
     // Draw the aiming line
-    glColor3f(1.0f, 1.0f, 1.0f); // White color for the aiming line
-    glEnable(GL_LINE_STIPPLE);
+    setColor(1.0f, 1.0f, 1.0f); // White color for the aiming line
+    Disable(GL_TEXTURE_2D);
+    Enable(GL_LINE_STIPPLE);
     glLineStipple(1, 0xAAAA); // Dotted line pattern
 
     glBegin(GL_LINES);
+    const Ball& ball = world.ball;
     glVertex2f(ball.x, ball.y);
-    glVertex2f(ball.x + 100 * cos(aimAngle), ball.y - 100 * sin(aimAngle)); // Adjust to point the line upwards
+    glVertex2f(ball.x + 100 * cos(world.aimAngle), ball.y - 100 * sin(world.aimAngle)); // Adjust to point the line upwards
     glEnd();
 
-    glDisable(GL_LINE_STIPPLE);
+    Disable(GL_LINE_STIPPLE);
 
     // Draw the aiming instruction
-    glRasterPos2f(SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 50); // Position the text
     std::string aimText = "Select direction and hit SPACE";
-    for (char ch : aimText) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the text
-    }
-}
-
-void resetGame() {
-    score = 0;
-    lives = 1; // Reset lives to 1
-    bricks.clear();
-    powerUps.clear();
-    bullets.clear();
-    setupBricks();
-    ball = Ball();
-    paddle = Paddle();
-    aimAngle = M_PI / 6; // Reset aim angle
-    bricksBroken = 0; // Reset the count of bricks broken
-
-    // Set initial movement for the ball
-    ball.dx = 0.4f;
-    ball.dy = -0.4f;
-    ball.idle = true; // Ensure the ball is idle and waiting for the player to start
+    drawText(aimText, SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 50, GLUT_BITMAP_TIMES_ROMAN_24);
 }
 
 
 
-void nextLevel() {
-    bricks.clear();
-    powerUps.clear();
-    bullets.clear();
-    setupBricks();
-    ball = Ball();
-    paddle = Paddle();
-    aimAngle = M_PI / 6; // Reset aim angle
-    bricksBroken = 0; // Reset the count of bricks broken
 
-    // Set initial movement for the ball
-    ball.dx = 0.4f; // You can adjust the speed as necessary
-    ball.dy = -0.4f; // Negative to move upwards
-    ball.idle = true; // Ensure the ball isn't marked as idle
-}
 
 void drawLives() {
-    glColor3f(1.0f, 1.0f, 1.0f); // Set text color to white
-    glRasterPos2f(SCREEN_WIDTH - 150, 30); // Set the position of the text
-    std::string livesString = "Lives: " + std::to_string(lives); // Convert the lives count to string
-    for (char ch : livesString) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, ch); // Draw each character of the lives string
-    }
+    setColor(1.0f, 1.0f, 1.0f); // Set text color to white
+    std::string livesString = "Lives: " + std::to_string(world.lives); // Convert the lives count to string
+    drawText(livesString, SCREEN_WIDTH - 150, 30, GLUT_BITMAP_TIMES_ROMAN_24);
 }
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
@@ -1300,12 +655,12 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
                 }
             }
             else if (currentGameState == LEVEL_COMPLETE) {
-                level++;
-                if (level > 3) {
+                if (world.level >= 3) {
                     currentGameState = WIN;
                 }
                 else {
-                    nextLevel();
+                    world.nextLevel();
+                    recorder.nextLevel();
                     currentGameState = AIM;
                 }
             }
@@ -1313,6 +668,9 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
                 currentGameState = MENU;
             }
             break;
+        case GLFW_KEY_F12:
+            TraceDump("trace.json"); // Snapshot of recent zones, if built with TRACE_ZONES
+            break;
         case GLFW_KEY_ESCAPE:
             if (currentGameState == GAME_OVER || currentGameState == WIN || currentGameState == LEVEL_COMPLETE) {
                 currentGameState = EXIT;
@@ -1322,21 +680,19 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
             }
             break;
         case GLFW_KEY_LEFT:
-            if (currentGameState == GAME && !ball.idle) {
-                paddle.moveLeft = true;
+            if (currentGameState == GAME && !world.ball.idle) {
+                input.moveLeft = true;
             }
             else if (currentGameState == AIM) {
-                aimAngle += 0.1f;
-                if (aimAngle > maxAimAngle) aimAngle = maxAimAngle;
+                input.aim++;
             }
             break;
         case GLFW_KEY_RIGHT:
-            if (currentGameState == GAME && !ball.idle) {
-                paddle.moveRight = true;
+            if (currentGameState == GAME && !world.ball.idle) {
+                input.moveRight = true;
             }
             else if (currentGameState == AIM) {
-                aimAngle -= 0.1f;
-                if (aimAngle < minAimAngle) aimAngle = minAimAngle;
+                input.aim--;
             }
             break;
         case GLFW_KEY_UP:
@@ -1357,49 +713,43 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
             break;
         case GLFW_KEY_1:
             if (currentGameState == LEVEL_SELECT) {
-                level = 1;
-                ball.setSpeed(BALL_SPEED_L1);
-                resetGame();
+                world.reset(1);
+                recorder.reset(1, BRICK_ROWS, BRICK_COLS);
                 currentGameState = AIM;
             }
             break;
         case GLFW_KEY_2:
             if (currentGameState == LEVEL_SELECT) {
-                level = 2;
-                ball.setSpeed(BALL_SPEED_L2);
-                resetGame();
+                world.reset(2);
+                recorder.reset(2, BRICK_ROWS, BRICK_COLS);
                 currentGameState = AIM;
             }
             break;
         case GLFW_KEY_3:
             if (currentGameState == LEVEL_SELECT) {
-                level = 3;
-                ball.setSpeed(BALL_SPEED_L3);
-                resetGame();
+                world.reset(3);
+                recorder.reset(3, BRICK_ROWS, BRICK_COLS);
                 currentGameState = AIM;
             }
             break;
         case GLFW_KEY_SPACE:
-            if (currentGameState == AIM || (currentGameState == GAME && ball.idle)) {
-                ball.dx = ball.dx * cos(aimAngle);
-                ball.dy = ball.dy * sin(aimAngle);
-                ball.idle = false;
-                paddle.moveLeft = false;  // Reset paddle movements
-                paddle.moveRight = false; // Reset paddle movements
-                currentGameState = GAME;
+            if (currentGameState == AIM || (currentGameState == GAME && world.ball.idle)) {
+                input.moveLeft = false;  // Reset paddle movements
+                input.moveRight = false; // Reset paddle movements
+                input.space = true; // Launch the ball
             }
             else if (currentGameState == GAME) {
-                shootGun();
+                input.space = true; // Fire the gun
             }
             break;
         }
     }
     else if (action == GLFW_RELEASE) {
         if (key == GLFW_KEY_LEFT && currentGameState == GAME) {
-            paddle.moveLeft = false;
+            input.moveLeft = false;
         }
         else if (key == GLFW_KEY_RIGHT && currentGameState == GAME) {
-            paddle.moveRight = false;
+            input.moveRight = false;
         }
     }
 }
@@ -1421,75 +771,122 @@ int main(void) {
 
     glfwMakeContextCurrent(window);
     glfwSetKeyCallback(window, key_callback);
+    glfwSwapInterval(1); // Sim runs on its own clock, so vsync no longer changes game speed
     initOpenGL();
-    loadBombTexture();
-    loadBrickTextures();
-    loadFireballTexture(); // Load fireball texture
-    loadBulletTexture(); // Load bullet texture
-    setupBricks();
-
+    if (!assetPack.open(assetPackFile) || !loadPackedAssets()) {
+        imageLoader.start(spriteFiles, NSPRITES); // loadSprites uploads them once decoded
+        textRenderer.init("Font/Arial.sdf"); // Baked by Apps/FontBaker; falls back to GLUT bitmap text if this fails
+    }
+    circleRenderer.init(); // Falls back to triangle fans if this fails
+    frameUniforms.init(); // Needed by any renderer that initialized, and available wherever they are
+    loadSounds();
+    uint64_t seed = (uint64_t) time(nullptr);
+    world.seed(seed);
+    recorder.begin(seed);
+    world.reset(1);
+    recorder.reset(1, BRICK_ROWS, BRICK_COLS);
+
+    double lastTime = glfwGetTime(), accumulator = 0;
     while (!glfwWindowShouldClose(window)) {
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        switch (currentGameState) {
-        case MENU:
-            drawMenu();
-            break;
-        case LEVEL_SELECT:
-            drawLevelSelect();
-            break;
-        case AIM:
-            drawAimingLine();
-            drawBall();
-            drawPaddle();
-            break;
-        case GAME:
-            updatePaddle();
-            drawBall();
-            drawPaddle();
-            for (const auto& brick : bricks) drawBrick(brick);
-            drawPowerUps();
-            drawBullets();
-            drawScore();
-            drawAmmoCount();
-            drawLives(); // Call the function here
-
-            if (!ball.idle) {
-                updateBall();
-            }
+        TRACE_ZONE("frame");
+        if (!spritesLoaded && (imageLoader.done() || currentGameState == AIM || currentGameState == GAME || currentGameState == POWER_UPS)) {
+            TRACE_ZONE("loadSprites");
+            loadSprites(); // The menu screens draw only text, so they don't wait for this
+        }
+        double now = glfwGetTime();
+        accumulator += now - lastTime;
+        lastTime = now;
+
+        if (currentGameState == AIM || currentGameState == GAME) {
+            // Run as many fixed ticks as real time allows, then interpolate the remainder
+            TRACE_ZONE("simulate");
+            int steps = 0;
+            while (accumulator >= SIM_DT && (currentGameState == AIM || currentGameState == GAME)) {
+                if (steps++ == MAX_STEPS_PER_FRAME) {
+                    accumulator = 0;
+                    break;
+                }
+                prevBall = world.ball;
+                prevPaddle = world.paddle;
+                world.step(input);
+                recorder.step(input);
+                input.aim = 0; // Edges are consumed by one tick
+                input.space = false;
+                currentGameState = world.state;
+                accumulator -= SIM_DT;
+            }
+            renderAlpha = (float) (accumulator / SIM_DT);
+            playSounds();
+        }
+        else {
+            accumulator = 0;
+        }
 
-            updatePowerUps();
-            updateBullets();
-            updateFireball();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-            if (std::all_of(bricks.begin(), bricks.end(), [](const Brick& b) { return !b.isVisible; })) {
-                currentGameState = LEVEL_COMPLETE;
+        {
+            TRACE_ZONE("draw");
+            frameUniforms.update(SCREEN_WIDTH, SCREEN_HEIGHT);
+            BindTexture(GL_TEXTURE_2D, sprites.texture); // The only texture the sprite draws use
+            switch (currentGameState) {
+            case MENU:
+                drawMenu();
+                break;
+            case LEVEL_SELECT:
+                drawLevelSelect();
+                break;
+            case AIM:
+                drawBricks();
+                drawAimingLine();
+                drawBall();
+                circleRenderer.draw(sprites.texture);
+                drawPaddle();
+                break;
+            case GAME:
+                // Moving sprites first: with equal depths the first draw wins, so they stay on top of bricks
+                drawBall();
+                drawPowerUps();
+                drawBullets();
+                circleRenderer.draw(sprites.texture);
+                drawPaddle();
+                drawBricks();
+                drawScore();
+                drawAmmoCount();
+                drawLives(); // Call the function here
+                break;
+            case GAME_OVER:
+                drawGameOver();
+                break;
+            case WIN:
+                drawWin();
+                break;
+            case LEVEL_COMPLETE:
+                drawLevelComplete();
+                break;
+            case EXIT:
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+                break;
+            case INSTRUCTIONS:
+                drawInstructions();
+                break;
+            case POWER_UPS:
+                drawPowerUpsScreen();
+                break;
             }
-            break;
-        case GAME_OVER:
-            drawGameOver();
-            break;
-        case WIN:
-            drawWin();
-            break;
-        case LEVEL_COMPLETE:
-            drawLevelComplete();
-            break;
-        case EXIT:
-            glfwSetWindowShouldClose(window, GLFW_TRUE);
-            break;
-        case INSTRUCTIONS:
-            drawInstructions();
-            break;
-        case POWER_UPS:
-            drawPowerUpsScreen();
-            break;
+            textRenderer.draw(); // Every string queued above, in one pass
         }
 
-        glfwSwapBuffers(window);
+        {
+            TRACE_ZONE("swapBuffers");
+            glfwSwapBuffers(window);
+        }
         glfwPollEvents();
     }
 
+    audio.stop();
+    recorder.end();
+    recorder.save("session.bbr");
+    TraceDump("trace.json"); // no-op unless built with TRACE_ZONES
     glfwTerminate();
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file